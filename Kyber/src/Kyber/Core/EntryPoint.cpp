@@ -1,4 +1,5 @@
 #include "Logger.hpp"
+#include "JobSystem.hpp"
 #include "Application.hpp"
 
 extern Kyber::Application* Kyber::CreateApplication();
@@ -6,10 +7,13 @@ extern Kyber::Application* Kyber::CreateApplication();
 auto main() -> int
 {
     Kyber::Logger::Init();
+    Kyber::JobSystem::Init();
 
     Kyber::Application* app = Kyber::CreateApplication();
     app->Run();
     delete app;
 
+    Kyber::JobSystem::Shutdown();
+
     Kyber::Logger::Shutdown();
 }
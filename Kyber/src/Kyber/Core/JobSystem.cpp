@@ -0,0 +1,281 @@
+#include "JobSystem.hpp"
+
+namespace Kyber {
+
+    namespace {
+
+        struct QueuedJob
+        {
+            Job job;
+            TaskGroup* group;
+        };
+
+        // Jobs here are coarse (a tile, a batch of rows), so a locked deque is cheap next to them
+        struct WorkQueue
+        {
+            std::mutex mutex;
+            std::deque<QueuedJob> jobs;
+        };
+
+        struct ParallelForState
+        {
+            std::function<void(usize, usize)> body;
+            usize count;
+            usize grain;
+            usize chunks;
+
+            std::atomic<usize> next { 0 };
+            std::atomic<usize> done { 0 };
+        };
+
+        std::vector<std::unique_ptr<WorkQueue>> s_Queues;
+        WorkQueue s_Injected;
+        std::vector<std::thread> s_Workers;
+
+        // Jobs queued anywhere, so idle workers know when to sleep
+        std::atomic<u64> s_Queued { 0 };
+        std::atomic<u32> s_Sleeping { 0 };
+        std::atomic<bool> s_Running { false };
+
+        std::mutex s_SleepMutex;
+        std::condition_variable s_WakeUp;
+
+        thread_local i32 t_WorkerIndex = -1;
+
+        auto PopBack(WorkQueue& queue, QueuedJob& out) -> bool
+        {
+            std::scoped_lock<std::mutex> lock(queue.mutex);
+            if (queue.jobs.empty()) return false;
+
+            out = std::move(queue.jobs.back());
+            queue.jobs.pop_back();
+            return true;
+        }
+
+        auto PopFront(WorkQueue& queue, QueuedJob& out) -> bool
+        {
+            std::scoped_lock<std::mutex> lock(queue.mutex);
+            if (queue.jobs.empty()) return false;
+
+            out = std::move(queue.jobs.front());
+            queue.jobs.pop_front();
+            return true;
+        }
+
+        // Own deque newest first, then the shared queue, then the oldest job of another worker
+        auto FindJob(QueuedJob& out) -> bool
+        {
+            i32 self = t_WorkerIndex;
+            if (self >= 0 && PopBack(*s_Queues[self], out)) return true;
+            if (PopFront(s_Injected, out)) return true;
+
+            usize count = s_Queues.size();
+            usize start = self >= 0 ? static_cast<usize>(self) + 1 : 0;
+
+            for (usize i = 0; i < count; ++i) {
+                usize victim = (start + i) % count;
+                if (static_cast<i32>(victim) == self) continue;
+                if (PopFront(*s_Queues[victim], out)) return true;
+            }
+
+            return false;
+        }
+
+        auto RunChunks(ParallelForState& state) -> void
+        {
+            usize chunk;
+            while ((chunk = state.next.fetch_add(1, std::memory_order_relaxed)) < state.chunks) {
+                usize begin = chunk * state.grain;
+                usize end = std::min(begin + state.grain, state.count);
+                state.body(begin, end);
+
+                if (state.done.fetch_add(1, std::memory_order_acq_rel) + 1 == state.chunks) {
+                    state.done.notify_all();
+                }
+            }
+        }
+
+    }
+
+    TaskGroup::~TaskGroup()
+    {
+        Wait();
+    }
+
+    auto TaskGroup::Run(Job job) -> void
+    {
+        JobSystem::Submit(std::move(job), this);
+    }
+
+    auto TaskGroup::Wait() -> void
+    {
+        // A worker that blocked here could starve the jobs it waits on, so it keeps running jobs instead
+        if (JobSystem::GetWorkerIndex() >= 0) {
+            while (!IsDone()) {
+                if (!JobSystem::TryRunJob()) {
+                    std::this_thread::yield();
+                }
+            }
+        }
+
+        std::unique_lock<std::mutex> lock(m_Mutex);
+        m_Done.wait(lock, [this]() { return m_Pending.load(std::memory_order_acquire) == 0; });
+    }
+
+    auto TaskGroup::Finish() -> void
+    {
+        std::scoped_lock<std::mutex> lock(m_Mutex);
+        if (m_Pending.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+            m_Done.notify_all();
+        }
+    }
+
+    auto JobSystem::Init(u32 workerCount) -> void
+    {
+        if (s_Initialized) return;
+
+        if (workerCount == 0) {
+            // hardware_concurrency may report zero when it can't tell
+            u32 hardwareThreads = std::thread::hardware_concurrency();
+            workerCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+        }
+
+        s_Queues.clear();
+        for (u32 i = 0; i < workerCount; ++i) {
+            s_Queues.push_back(std::make_unique<WorkQueue>());
+        }
+
+        s_Running = true;
+
+        for (u32 i = 0; i < workerCount; ++i) {
+            s_Workers.emplace_back([i]() {
+                t_WorkerIndex = static_cast<i32>(i);
+
+                while (true) {
+                    if (TryRunJob()) continue;
+
+                    std::unique_lock<std::mutex> lock(s_SleepMutex);
+                    s_Sleeping++;
+                    s_WakeUp.wait(lock, []() { return s_Queued.load() > 0 || !s_Running; });
+                    s_Sleeping--;
+
+                    if (!s_Running && s_Queued.load() == 0) return;
+                }
+            });
+        }
+
+        s_Initialized = true;
+        KINFO("Job system started with {} workers", workerCount);
+    }
+
+    auto JobSystem::Shutdown() -> void
+    {
+        if (!s_Initialized) return;
+
+        // Workers drain whatever is still queued before they exit
+        {
+            std::scoped_lock<std::mutex> lock(s_SleepMutex);
+            s_Running = false;
+        }
+        s_WakeUp.notify_all();
+
+        for (auto& worker : s_Workers) {
+            worker.join();
+        }
+
+        s_Workers.clear();
+        s_Queues.clear();
+        s_Initialized = false;
+    }
+
+    auto JobSystem::Submit(Job job, TaskGroup* group) -> void
+    {
+        if (group) {
+            group->m_Pending.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        // Without a pool there is nobody else to run it
+        if (!s_Initialized) {
+            job();
+            if (group) group->Finish();
+            return;
+        }
+
+        i32 self = t_WorkerIndex;
+        WorkQueue& queue = self >= 0 ? *s_Queues[self] : s_Injected;
+
+        // Counted before it is visible, so a thief can't take the count below zero
+        s_Queued.fetch_add(1, std::memory_order_relaxed);
+
+        {
+            std::scoped_lock<std::mutex> lock(queue.mutex);
+            queue.jobs.push_back({ std::move(job), group });
+        }
+
+        // Taking the lock orders this against a worker checking the count on its way to sleep
+        {
+            std::scoped_lock<std::mutex> lock(s_SleepMutex);
+        }
+        s_WakeUp.notify_one();
+    }
+
+    auto JobSystem::ParallelFor(usize count, usize grain, const std::function<void(usize begin, usize end)>& body) -> void
+    {
+        if (count == 0) return;
+
+        grain = std::max<usize>(grain, 1);
+        usize chunks = (count + grain - 1) / grain;
+
+        if (chunks == 1 || !s_Initialized) {
+            body(0, count);
+            return;
+        }
+
+        // Helpers can start after the loop is over, so they hold the state rather than the caller's stack
+        auto state = std::make_shared<ParallelForState>();
+        state->body = body;
+        state->count = count;
+        state->grain = grain;
+        state->chunks = chunks;
+
+        // Only as many helpers as there are idle workers; with the pool busy the caller does it all, and
+        // no helpers are left queued behind long jobs
+        usize helpers = std::min<usize>(chunks - 1, s_Sleeping.load(std::memory_order_relaxed));
+        for (usize i = 0; i < helpers; ++i) {
+            Submit([state]() { RunChunks(*state); });
+        }
+
+        RunChunks(*state);
+
+        usize done;
+        while ((done = state->done.load(std::memory_order_acquire)) < chunks) {
+            state->done.wait(done, std::memory_order_acquire);
+        }
+    }
+
+    auto JobSystem::GetWorkerCount() -> u32
+    {
+        return static_cast<u32>(s_Queues.size());
+    }
+
+    auto JobSystem::GetWorkerIndex() -> i32
+    {
+        return t_WorkerIndex;
+    }
+
+    auto JobSystem::TryRunJob() -> bool
+    {
+        QueuedJob queued;
+        if (!FindJob(queued)) return false;
+
+        s_Queued.fetch_sub(1, std::memory_order_relaxed);
+        queued.job();
+
+        if (queued.group) {
+            queued.group->Finish();
+        }
+
+        return true;
+    }
+
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+namespace Kyber {
+
+    using Job = std::function<void()>;
+
+    // Counts the jobs run through it so they can be waited on together
+    class TaskGroup
+    {
+    public:
+        TaskGroup() = default;
+        ~TaskGroup();
+
+        TaskGroup(const TaskGroup&) = delete;
+        auto operator=(const TaskGroup&) -> TaskGroup& = delete;
+
+        auto Run(Job job) -> void;
+
+        // On a worker this runs other jobs while it waits; elsewhere it blocks
+        auto Wait() -> void;
+
+        auto IsDone() const -> bool
+        {
+            return m_Pending.load(std::memory_order_acquire) == 0;
+        }
+
+    private:
+        friend class JobSystem;
+
+        auto Finish() -> void;
+
+    private:
+        std::atomic<u32> m_Pending { 0 };
+
+        // The last job signals under the lock, so a waiter can't destroy the group while it does
+        std::mutex m_Mutex;
+        std::condition_variable m_Done;
+    };
+
+    // A fixed pool of worker threads shared by every layer. Each worker owns a deque: it pushes and pops
+    // its own jobs at the back, and when it runs dry it steals from the front of the others. Jobs from
+    // threads outside the pool go through a shared queue. The pool is sized to leave the main thread
+    // its own core, so work scheduled here never oversubscribes the machine.
+    class JobSystem
+    {
+    public:
+        static auto Init(u32 workerCount = 0) -> void;
+        static auto Shutdown() -> void;
+
+        static auto Submit(Job job, TaskGroup* group = nullptr) -> void;
+
+        // Calls body over [0, count) in chunks of at most grain. The caller works through chunks too and
+        // returns once all are done, so it finishes even when every worker is busy with something else.
+        static auto ParallelFor(usize count, usize grain, const std::function<void(usize begin, usize end)>& body) -> void;
+
+        static auto GetWorkerCount() -> u32;
+
+        // Index of the calling worker, or -1 off the pool
+        static auto GetWorkerIndex() -> i32;
+
+    private:
+        friend class TaskGroup;
+
+        static auto TryRunJob() -> bool;
+
+    private:
+        inline static bool s_Initialized { false };
+    };
+
+}
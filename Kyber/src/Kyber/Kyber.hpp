@@ -5,3 +5,4 @@
 #include "Core/Events.hpp"
 #include "Core/Input.hpp"
 #include "Core/Layer.hpp"
+#include "Core/JobSystem.hpp"
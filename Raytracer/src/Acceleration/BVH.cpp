@@ -1,5 +1,10 @@
 #include "BVH.hpp"
 
+#include "TreeletOptimizer.hpp"
+
+#include "Core/SIMD.hpp"
+#include "Core/Morton.hpp"
+
 namespace Kyber {
 
     namespace {
@@ -11,6 +16,7 @@ namespace Kyber {
             u32 splitAxis;
             u32 firstPrimOffset;
             u32 nPrimitives;
+            u32 subtreeNodes;
 
             auto InitLeaf(u32 first, u32 n, const AABB& b) -> void
             {
@@ -19,6 +25,7 @@ namespace Kyber {
                 bounds = b;
                 children[0] = nullptr;
                 children[1] = nullptr;
+                subtreeNodes = 1;
             }
 
             auto InitInterior(u32 axis, BVHBuildNode* c0, BVHBuildNode* c1) -> void
@@ -28,9 +35,39 @@ namespace Kyber {
                 bounds = AABB(c0->bounds, c1->bounds);
                 splitAxis = axis;
                 nPrimitives = 0;
+                subtreeNodes = 1 + c0->subtreeNodes + c1->subtreeNodes;
             }
         };
 
+        struct BVHPrimitive
+        {
+            AABB bounds;
+            glm::vec3 centroid;
+            u32 index;
+        };
+
+        struct BVHBin
+        {
+            AABB bounds;
+            u32 count { 0 };
+        };
+
+        struct BVHRangeBounds
+        {
+            AABB bounds;
+            AABB centroidBounds;
+        };
+
+        constexpr f32 TraversalCost = 1.0f;
+        constexpr f32 IntersectCost = 1.0f;
+
+        constexpr u32 MaxBinCount = 64;
+        constexpr u32 MaxLeafPrimitives = 64;
+
+        // Ranges above these sizes are split into tasks / reduced with the parallel algorithms
+        constexpr u32 ParallelTaskThreshold = 8 * 1024;
+        constexpr u32 ParallelReduceThreshold = 64 * 1024;
+
         auto GetCentroid(const AABB& bbox) -> glm::vec3
         {
             return glm::vec3(
@@ -40,67 +77,243 @@ namespace Kyber {
             );
         }
 
-        auto BuildBVHRecursive(
-            std::vector<std::shared_ptr<Hittable>>& primitives,
-            u32 start, u32 end,
-            u32& totalNodes,
-            u32& totalLeaves,
-            u32 depth, u32& maxDepth
-        ) -> BVHBuildNode*
+        class BVHBuilder
         {
-            maxDepth = std::max(maxDepth, depth);
-            BVHBuildNode* node = new BVHBuildNode();
-            totalNodes++;
+        public:
+            BVHBuilder(std::vector<BVHPrimitive>& primitives, const BVHBuildOptions& options)
+                : m_Primitives(primitives)
+                , m_Options(options)
+                , m_BinCount(std::clamp(options.BinCount, 2u, MaxBinCount))
+                , m_MaxLeafPrimitives(std::clamp(options.MaxLeafPrimitives, 1u, MaxLeafPrimitives))
+                , m_Arena(2 * primitives.size() - 1)
+            {
+                u32 workers = std::max(1u, std::thread::hardware_concurrency());
+                m_MaxTaskDepth = static_cast<u32>(std::bit_width(workers)) + 2;
+            }
 
-            AABB centroidBounds;
-            AABB bbox;
-            for (u32 i = start; i < end; ++i) {
-                AABB pb = primitives[i]->GetBBox();
-                glm::vec3 c = GetCentroid(pb);
-                centroidBounds = AABB(centroidBounds, AABB(c, c));
-                bbox = AABB(bbox, pb);
-            }
-
-            u32 nPrimitives = end - start;
-            if (nPrimitives == 1) {
-                node->InitLeaf(start, nPrimitives, bbox);
-                totalLeaves++;
-                return node;
+            auto Build() -> BVHBuildNode*
+            {
+                return BuildRecursive(0, static_cast<u32>(m_Primitives.size()), 0);
             }
 
-            AABB nodeBounds = bbox;
+            auto GetTotalNodes() const -> u32 { return m_TotalNodes.load(); }
+            auto GetTotalLeaves() const -> u32 { return m_TotalLeaves.load(); }
+            auto GetMaxDepth() const -> u32 { return m_MaxDepth.load(); }
+            auto GetMaxTaskDepth() const -> u32 { return m_MaxTaskDepth; }
 
-            i32 axis = 0;
-            f32 maxExtent = centroidBounds.x.Size();
-            if (centroidBounds.y.Size() > maxExtent) {
-                axis = 1;
-                maxExtent = centroidBounds.y.Size();
+        private:
+            auto AllocateNode() -> BVHBuildNode*
+            {
+                return &m_Arena[m_TotalNodes.fetch_add(1, std::memory_order_relaxed)];
             }
-            if (centroidBounds.z.Size() > maxExtent) {
-                axis = 2;
+
+            auto ComputeBounds(u32 start, u32 end) const -> BVHRangeBounds
+            {
+                auto merge = [](const BVHRangeBounds& a, const BVHRangeBounds& b) -> BVHRangeBounds {
+                    return { AABB(a.bounds, b.bounds), AABB(a.centroidBounds, b.centroidBounds) };
+                };
+
+                auto toBounds = [](const BVHPrimitive& primitive) -> BVHRangeBounds {
+                    return { primitive.bounds, AABB(primitive.centroid, primitive.centroid) };
+                };
+
+                auto first = m_Primitives.begin() + start;
+                auto last = m_Primitives.begin() + end;
+
+                if (end - start >= ParallelReduceThreshold) {
+                    return std::transform_reduce(std::execution::par, first, last, BVHRangeBounds {}, merge, toBounds);
+                }
+
+                return std::transform_reduce(first, last, BVHRangeBounds {}, merge, toBounds);
             }
 
-            u32 mid = (start + end) / 2;
-            std::nth_element(primitives.begin() + start, primitives.begin() + mid, primitives.begin() + end,
-                [axis](const std::shared_ptr<Hittable>& a, const std::shared_ptr<Hittable>& b) -> bool {
-                    glm::vec3 ca = GetCentroid(a->GetBBox());
-                    glm::vec3 cb = GetCentroid(b->GetBBox());
-                    return ca[axis] < cb[axis];
+            auto SplitMedian(u32 start, u32 end, i32 axis) -> u32
+            {
+                u32 mid = (start + end) / 2;
+
+                auto compare = [axis](const BVHPrimitive& a, const BVHPrimitive& b) -> bool {
+                    return a.centroid[axis] < b.centroid[axis];
+                };
+
+                auto first = m_Primitives.begin() + start;
+                auto last = m_Primitives.begin() + end;
+
+                if (end - start >= ParallelReduceThreshold) {
+                    std::nth_element(std::execution::par, first, m_Primitives.begin() + mid, last, compare);
+                } else {
+                    std::nth_element(first, m_Primitives.begin() + mid, last, compare);
                 }
-            );
 
-            node->InitInterior(axis,
-                BuildBVHRecursive(primitives, start, mid, totalNodes, totalLeaves, depth + 1, maxDepth),
-                BuildBVHRecursive(primitives, mid, end, totalNodes, totalLeaves, depth + 1, maxDepth)
-            );
+                return mid;
+            }
 
-            return node;
-        }
+            // Returns the split position, or nothing when the SAH prefers keeping the range as a single leaf
+            auto SplitSAH(u32 start, u32 end, i32 axis, const AABB& bounds, const AABB& centroidBounds) -> std::optional<u32>
+            {
+                const u32 nPrimitives = end - start;
+                const bool canBeLeaf = nPrimitives <= m_MaxLeafPrimitives;
+
+                const Interval& extent = centroidBounds.AxisInterval(axis);
+                if (extent.Size() <= 0.0f) {
+                    if (canBeLeaf) return std::nullopt;
+                    return SplitMedian(start, end, axis);
+                }
+
+                const u32 binCount = m_BinCount;
+                auto binIndex = [&](const BVHPrimitive& primitive) -> u32 {
+                    f32 offset = (primitive.centroid[axis] - extent.min) / extent.Size();
+                    return std::min(static_cast<u32>(offset * static_cast<f32>(binCount)), binCount - 1);
+                };
+
+                std::array<BVHBin, MaxBinCount> bins {};
+                for (u32 i = start; i < end; ++i) {
+                    BVHBin& bin = bins[binIndex(m_Primitives[i])];
+                    bin.count++;
+                    bin.bounds = AABB(bin.bounds, m_Primitives[i].bounds);
+                }
+
+                // Sweep from the right to gather suffix areas, then from the left to evaluate each split plane
+                std::array<f32, MaxBinCount> rightArea {};
+                std::array<u32, MaxBinCount> rightCount {};
+
+                AABB rightBounds;
+                u32 countRight = 0;
+                for (u32 i = binCount - 1; i > 0; --i) {
+                    rightBounds = AABB(rightBounds, bins[i].bounds);
+                    countRight += bins[i].count;
+                    rightArea[i - 1] = rightBounds.SurfaceArea();
+                    rightCount[i - 1] = countRight;
+                }
+
+                AABB leftBounds;
+                u32 countLeft = 0;
+                u32 bestSplit = 0;
+                f32 bestCost = std::numeric_limits<f32>::infinity();
+                for (u32 i = 0; i < binCount - 1; ++i) {
+                    leftBounds = AABB(leftBounds, bins[i].bounds);
+                    countLeft += bins[i].count;
+
+                    if (countLeft == 0 || rightCount[i] == 0) continue;
+
+                    f32 cost = static_cast<f32>(countLeft) * leftBounds.SurfaceArea()
+                        + static_cast<f32>(rightCount[i]) * rightArea[i];
+
+                    if (cost < bestCost) {
+                        bestCost = cost;
+                        bestSplit = i;
+                    }
+                }
+
+                if (bestCost == std::numeric_limits<f32>::infinity()) {
+                    if (canBeLeaf) return std::nullopt;
+                    return SplitMedian(start, end, axis);
+                }
+
+                if (canBeLeaf) {
+                    f32 area = bounds.SurfaceArea();
+                    f32 leafCost = IntersectCost * static_cast<f32>(nPrimitives);
+                    f32 splitCost = area > 0.0f ? TraversalCost + IntersectCost * bestCost / area : leafCost;
+
+                    if (leafCost <= splitCost) return std::nullopt;
+                }
+
+                auto isLeft = [&](const BVHPrimitive& primitive) -> bool {
+                    return binIndex(primitive) <= bestSplit;
+                };
+
+                auto first = m_Primitives.begin() + start;
+                auto last = m_Primitives.begin() + end;
+
+                auto midIt = (end - start >= ParallelReduceThreshold)
+                    ? std::partition(std::execution::par, first, last, isLeft)
+                    : std::partition(first, last, isLeft);
+
+                u32 mid = static_cast<u32>(midIt - m_Primitives.begin());
+                if (mid == start || mid == end) {
+                    return SplitMedian(start, end, axis);
+                }
+
+                return mid;
+            }
+
+            auto BuildRecursive(u32 start, u32 end, u32 depth) -> BVHBuildNode*
+            {
+                u32 currentMax = m_MaxDepth.load(std::memory_order_relaxed);
+                while (depth > currentMax && !m_MaxDepth.compare_exchange_weak(currentMax, depth, std::memory_order_relaxed)) {}
+
+                BVHBuildNode* node = AllocateNode();
+
+                auto [bbox, centroidBounds] = ComputeBounds(start, end);
+
+                u32 nPrimitives = end - start;
+                if (nPrimitives == 1) {
+                    node->InitLeaf(start, nPrimitives, bbox);
+                    m_TotalLeaves.fetch_add(1, std::memory_order_relaxed);
+                    return node;
+                }
+
+                i32 axis = 0;
+                f32 maxExtent = centroidBounds.x.Size();
+                if (centroidBounds.y.Size() > maxExtent) {
+                    axis = 1;
+                    maxExtent = centroidBounds.y.Size();
+                }
+                if (centroidBounds.z.Size() > maxExtent) {
+                    axis = 2;
+                }
+
+                u32 mid = 0;
+                switch (m_Options.SplitMethod) {
+                    case BVHSplitMethod::SAH:
+                        if (auto split = SplitSAH(start, end, axis, bbox, centroidBounds)) {
+                            mid = *split;
+                        } else {
+                            node->InitLeaf(start, nPrimitives, bbox);
+                            m_TotalLeaves.fetch_add(1, std::memory_order_relaxed);
+                            return node;
+                        }
+                        break;
+                    case BVHSplitMethod::Median:
+                    default:
+                        mid = SplitMedian(start, end, axis);
+                        break;
+                }
+
+                BVHBuildNode* left = nullptr;
+                BVHBuildNode* right = nullptr;
+
+                if (nPrimitives >= ParallelTaskThreshold && depth < m_MaxTaskDepth) {
+                    auto task = std::async(std::launch::async, [this, start, mid, depth]() -> BVHBuildNode* {
+                        return BuildRecursive(start, mid, depth + 1);
+                    });
+                    right = BuildRecursive(mid, end, depth + 1);
+                    left = task.get();
+                } else {
+                    left = BuildRecursive(start, mid, depth + 1);
+                    right = BuildRecursive(mid, end, depth + 1);
+                }
+
+                node->InitInterior(axis, left, right);
+
+                return node;
+            }
+
+        private:
+            std::vector<BVHPrimitive>& m_Primitives;
+            const BVHBuildOptions& m_Options;
+            u32 m_BinCount;
+            u32 m_MaxLeafPrimitives;
+            u32 m_MaxTaskDepth { 0 };
 
-        auto FlattenBVHTree(BVHBuildNode* node, std::vector<LinearBVHNode>& nodes) -> u32 
+            std::vector<BVHBuildNode> m_Arena;
+            std::atomic<u32> m_TotalNodes { 0 };
+            std::atomic<u32> m_TotalLeaves { 0 };
+            std::atomic<u32> m_MaxDepth { 0 };
+        };
+
+        // Splits into tasks only above maxTaskDepth, like the build, so the thread count stays bounded
+        auto FlattenBVHTree(const BVHBuildNode* node, std::vector<LinearBVHNode>& nodes, u32 offset, u32 depth, u32 maxTaskDepth) -> void
         {
-            u32 offset = static_cast<u32>(nodes.size());
-            nodes.push_back({});
             LinearBVHNode& linearNode = nodes[offset];
 
             linearNode.bounds = node->bounds;
@@ -110,62 +323,591 @@ namespace Kyber {
             if (node->nPrimitives > 0) {
                 linearNode.primitivesOffset = node->firstPrimOffset;
                 linearNode.axis = 0;
+                return;
+            }
+
+            // Depth-first layout: the first child follows its parent, the second child follows the first subtree
+            u32 firstOffset = offset + 1;
+            u32 secondOffset = firstOffset + node->children[0]->subtreeNodes;
+
+            linearNode.axis = static_cast<u8>(node->splitAxis);
+            linearNode.secondChildOffset = secondOffset;
+
+            if (node->subtreeNodes >= 2 * ParallelTaskThreshold && depth < maxTaskDepth) {
+                auto task = std::async(std::launch::async, [&]() {
+                    FlattenBVHTree(node->children[0], nodes, firstOffset, depth + 1, maxTaskDepth);
+                });
+                FlattenBVHTree(node->children[1], nodes, secondOffset, depth + 1, maxTaskDepth);
+                task.get();
             } else {
-                linearNode.axis = static_cast<u8>(node->splitAxis);
-                FlattenBVHTree(node->children[0], nodes);
-                linearNode.secondChildOffset = FlattenBVHTree(node->children[1], nodes);
+                FlattenBVHTree(node->children[0], nodes, firstOffset, depth + 1, maxTaskDepth);
+                FlattenBVHTree(node->children[1], nodes, secondOffset, depth + 1, maxTaskDepth);
             }
+        }
+
+        // Stable LSD radix sort on bits [firstBit, lastBit) of the keys; chunks are histogrammed and scattered in parallel
+        auto RadixSortKeys(std::vector<u64>& keys, u32 firstBit, u32 lastBit) -> void
+        {
+            constexpr u32 RadixBits = 8;
+            constexpr u32 BucketCount = 1u << RadixBits;
+
+            const usize count = keys.size();
+            const usize chunkCount = count >= ParallelReduceThreshold ? 4 * std::max(1u, std::thread::hardware_concurrency()) : 1;
+            const usize chunkSize = (count + chunkCount - 1) / chunkCount;
+
+            std::vector<u64> scratch(count);
+            std::vector<std::array<u32, BucketCount>> offsets(chunkCount);
+
+            for (u32 shift = firstBit; shift < lastBit; shift += RadixBits) {
+                std::for_each(std::execution::par, offsets.begin(), offsets.end(), [&](std::array<u32, BucketCount>& histogram) {
+                    usize chunk = static_cast<usize>(&histogram - offsets.data());
+                    usize first = std::min(count, chunk * chunkSize);
+                    usize last = std::min(count, first + chunkSize);
+
+                    histogram.fill(0);
+                    for (usize i = first; i < last; ++i) {
+                        histogram[(keys[i] >> shift) & (BucketCount - 1)]++;
+                    }
+                });
 
-            return offset;
+                // Digit-major prefix sum so each chunk scatters after the earlier chunks' keys of the same digit
+                u32 sum = 0;
+                for (u32 digit = 0; digit < BucketCount; ++digit) {
+                    for (auto& histogram : offsets) {
+                        u32 bucket = histogram[digit];
+                        histogram[digit] = sum;
+                        sum += bucket;
+                    }
+                }
+
+                std::for_each(std::execution::par, offsets.begin(), offsets.end(), [&](std::array<u32, BucketCount>& offset) {
+                    usize chunk = static_cast<usize>(&offset - offsets.data());
+                    usize first = std::min(count, chunk * chunkSize);
+                    usize last = std::min(count, first + chunkSize);
+
+                    for (usize i = first; i < last; ++i) {
+                        scratch[offset[(keys[i] >> shift) & (BucketCount - 1)]++] = keys[i];
+                    }
+                });
+
+                std::swap(keys, scratch);
+            }
         }
 
-        auto DeleteBVHBuildNode(BVHBuildNode* node) -> void 
+        // Linear BVH: primitives are sorted along a Morton curve and split at the highest differing code bit.
+        // Every leaf holds one primitive, so a range of n primitives owns exactly 2n - 1 nodes and each
+        // node's depth-first offset is known up front, letting the hierarchy be emitted straight into place.
+        class LBVHBuilder
         {
-            if (node) {
-                if (node->children[0]) DeleteBVHBuildNode(node->children[0]);
-                if (node->children[1]) DeleteBVHBuildNode(node->children[1]);
-                delete node;
+        public:
+            LBVHBuilder(std::vector<BVHPrimitive>& primitives)
+                : m_Primitives(primitives)
+            {
+                u32 workers = std::max(1u, std::thread::hardware_concurrency());
+                m_MaxTaskDepth = static_cast<u32>(std::bit_width(workers)) + 2;
+            }
+
+            auto Build(std::vector<LinearBVHNode>& nodes) -> void
+            {
+                SortPrimitives();
+
+                u32 count = static_cast<u32>(m_Primitives.size());
+                nodes.resize(2 * count - 1);
+                Emit(nodes, 0, count, 0, 0);
+            }
+
+            auto GetMaxDepth() const -> u32 { return m_MaxDepth.load(); }
+
+        private:
+            auto SortPrimitives() -> void
+            {
+                const usize count = m_Primitives.size();
+
+                auto merge = [](const AABB& a, const AABB& b) -> AABB { return AABB(a, b); };
+                auto toBounds = [](const BVHPrimitive& primitive) -> AABB { return AABB(primitive.centroid, primitive.centroid); };
+
+                AABB centroidBounds = (count >= ParallelReduceThreshold)
+                    ? std::transform_reduce(std::execution::par, m_Primitives.begin(), m_Primitives.end(), AABB(), merge, toBounds)
+                    : std::transform_reduce(m_Primitives.begin(), m_Primitives.end(), AABB(), merge, toBounds);
+
+                glm::vec3 lo(centroidBounds.x.min, centroidBounds.y.min, centroidBounds.z.min);
+                glm::vec3 extent(centroidBounds.x.Size(), centroidBounds.y.Size(), centroidBounds.z.Size());
+                glm::vec3 scale(
+                    extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+                    extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+                    extent.z > 0.0f ? 1.0f / extent.z : 0.0f
+                );
+
+                // Morton code in the high word, original index in the low word
+                std::vector<u64> keys(count);
+                std::for_each(std::execution::par, keys.begin(), keys.end(), [&](u64& key) {
+                    u32 index = static_cast<u32>(&key - keys.data());
+                    u32 code = Morton3D((m_Primitives[index].centroid - lo) * scale);
+                    key = (static_cast<u64>(code) << 32) | index;
+                });
+
+                RadixSortKeys(keys, 32, 64);
+
+                std::vector<BVHPrimitive> sorted(count);
+                m_Codes.resize(count);
+                std::for_each(std::execution::par, keys.begin(), keys.end(), [&](const u64& key) {
+                    usize slot = static_cast<usize>(&key - keys.data());
+                    sorted[slot] = m_Primitives[static_cast<u32>(key)];
+                    m_Codes[slot] = static_cast<u32>(key >> 32);
+                });
+
+                m_Primitives = std::move(sorted);
+            }
+
+            auto FindSplit(u32 start, u32 end, u32& axis) const -> u32
+            {
+                u32 first = m_Codes[start];
+                u32 last = m_Codes[end - 1];
+
+                // Identical codes carry no spatial information, fall back to an even split
+                if (first == last) {
+                    axis = 0;
+                    return (start + end) / 2;
+                }
+
+                // Codes interleave as ...xyz, so bit 0 belongs to z
+                u32 bit = 31 - static_cast<u32>(std::countl_zero(first ^ last));
+                axis = 2 - bit % 3;
+
+                auto it = std::partition_point(m_Codes.begin() + start, m_Codes.begin() + end, [bit](u32 code) {
+                    return (code & (1u << bit)) == 0;
+                });
+
+                return static_cast<u32>(it - m_Codes.begin());
+            }
+
+            auto Emit(std::vector<LinearBVHNode>& nodes, u32 start, u32 end, u32 offset, u32 depth) -> AABB
+            {
+                u32 currentMax = m_MaxDepth.load(std::memory_order_relaxed);
+                while (depth > currentMax && !m_MaxDepth.compare_exchange_weak(currentMax, depth, std::memory_order_relaxed)) {}
+
+                LinearBVHNode& node = nodes[offset];
+                node.pad = 0;
+
+                if (end - start == 1) {
+                    node.bounds = m_Primitives[start].bounds;
+                    node.primitivesOffset = start;
+                    node.nPrimitives = 1;
+                    node.axis = 0;
+                    return node.bounds;
+                }
+
+                u32 axis = 0;
+                u32 mid = FindSplit(start, end, axis);
+
+                u32 firstOffset = offset + 1;
+                u32 secondOffset = offset + 2 * (mid - start);
+
+                node.secondChildOffset = secondOffset;
+                node.nPrimitives = 0;
+                node.axis = static_cast<u8>(axis);
+
+                AABB left;
+                AABB right;
+
+                if (end - start >= ParallelTaskThreshold && depth < m_MaxTaskDepth) {
+                    auto task = std::async(std::launch::async, [&, start, mid, firstOffset, depth]() -> AABB {
+                        return Emit(nodes, start, mid, firstOffset, depth + 1);
+                    });
+                    right = Emit(nodes, mid, end, secondOffset, depth + 1);
+                    left = task.get();
+                } else {
+                    left = Emit(nodes, start, mid, firstOffset, depth + 1);
+                    right = Emit(nodes, mid, end, secondOffset, depth + 1);
+                }
+
+                node.bounds = AABB(left, right);
+                return node.bounds;
+            }
+
+        private:
+            std::vector<BVHPrimitive>& m_Primitives;
+            std::vector<u32> m_Codes;
+            u32 m_MaxTaskDepth { 0 };
+
+            std::atomic<u32> m_MaxDepth { 0 };
+        };
+
+        auto SplitMethodName(BVHSplitMethod method) -> const char*
+        {
+            switch (method) {
+                case BVHSplitMethod::SAH: return "SAH";
+                case BVHSplitMethod::LBVH: return "LBVH";
+                case BVHSplitMethod::Median:
+                default: return "Median";
             }
         }
+
+        // Slab test of one box against the lanes in laneMask, four lanes per SSE step
+        template <usize N>
+        auto IntersectBoxPacket(const AABB& box, const RayPacket<N>& packet, f32 tMin, u32 laneMask) -> u32
+        {
+            u32 mask = 0;
+
+            for (u32 group = 0; group < RayPacket<N>::Groups; ++group) {
+                const u32 lane0 = group * 4;
+                if (((laneMask >> lane0) & 0xFu) == 0) continue;
+
+#if KYBER_SIMD_SSE
+                const __m128 ox = _mm_load_ps(&packet.originX[lane0]);
+                const __m128 oy = _mm_load_ps(&packet.originY[lane0]);
+                const __m128 oz = _mm_load_ps(&packet.originZ[lane0]);
+
+                const __m128 ix = _mm_load_ps(&packet.invDirX[lane0]);
+                const __m128 iy = _mm_load_ps(&packet.invDirY[lane0]);
+                const __m128 iz = _mm_load_ps(&packet.invDirZ[lane0]);
+
+                const __m128 tx0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.x.min), ox), ix);
+                const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.x.max), ox), ix);
+                const __m128 ty0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.y.min), oy), iy);
+                const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.y.max), oy), iy);
+                const __m128 tz0 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.z.min), oz), iz);
+                const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(box.z.max), oz), iz);
+
+                const __m128 tmin = _mm_max_ps(
+                    _mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)),
+                    _mm_max_ps(_mm_min_ps(tz0, tz1), _mm_set1_ps(tMin))
+                );
+                const __m128 robust = _mm_set1_ps(SlabRobustFactor);
+                const __m128 tmax = _mm_min_ps(
+                    _mm_mul_ps(_mm_min_ps(_mm_max_ps(tx0, tx1), _mm_min_ps(_mm_max_ps(ty0, ty1), _mm_max_ps(tz0, tz1))), robust),
+                    _mm_load_ps(&packet.tMax[lane0])
+                );
+
+                mask |= static_cast<u32>(_mm_movemask_ps(_mm_cmple_ps(tmin, tmax))) << lane0;
+#else
+                for (u32 lane = lane0; lane < lane0 + 4; ++lane) {
+                    Interval clip(tMin, packet.tMax[lane]);
+                    if (box.Hit(RayQuery(packet.GetRay(lane)), clip)) {
+                        mask |= 1u << lane;
+                    }
+                }
+#endif
+            }
+
+            return mask & laneMask;
+        }
+
+        template <typename TBoundsFn>
+        auto RefitNode(std::vector<LinearBVHNode>& nodes, u32 index, const TBoundsFn& primitiveBounds) -> void
+        {
+            LinearBVHNode& node = nodes[index];
+
+            if (node.nPrimitives > 0) {
+                AABB bounds;
+                for (u32 i = 0; i < node.nPrimitives; ++i) {
+                    bounds = AABB(bounds, primitiveBounds(node.primitivesOffset + i));
+                }
+                node.bounds = bounds;
+            } else {
+                node.bounds = AABB(nodes[index + 1].bounds, nodes[node.secondChildOffset].bounds);
+            }
+        }
+
+        // Splits the depth-first node array into independent subtree ranges plus the nodes above them
+        auto CollectRefitRanges(
+            const std::vector<LinearBVHNode>& nodes,
+            u32 index,
+            u32 depth,
+            u32 maxDepth,
+            std::vector<std::pair<u32, u32>>& ranges,
+            std::vector<u32>& topNodes
+        ) -> void
+        {
+            const LinearBVHNode& node = nodes[index];
+
+            if (depth < maxDepth && node.nPrimitives == 0) {
+                topNodes.push_back(index);
+                CollectRefitRanges(nodes, index + 1, depth + 1, maxDepth, ranges, topNodes);
+                CollectRefitRanges(nodes, node.secondChildOffset, depth + 1, maxDepth, ranges, topNodes);
+                return;
+            }
+
+            // A subtree is contiguous and ends after its rightmost leaf
+            u32 last = index;
+            while (nodes[last].nPrimitives == 0) {
+                last = nodes[last].secondChildOffset;
+            }
+
+            ranges.emplace_back(index, last + 1);
+        }
+
+        auto ComputeTreeDepth(const std::vector<LinearBVHNode>& nodes) -> u32
+        {
+            u32 maxDepth = 0;
+            std::vector<std::pair<u32, u32>> stack { { 0, 0 } };
+
+            while (!stack.empty()) {
+                auto [index, depth] = stack.back();
+                stack.pop_back();
+
+                maxDepth = std::max(maxDepth, depth);
+                if (nodes[index].nPrimitives == 0) {
+                    stack.emplace_back(index + 1, depth + 1);
+                    stack.emplace_back(nodes[index].secondChildOffset, depth + 1);
+                }
+            }
+
+            return maxDepth;
+        }
+
+        auto ComputeSAHCost(const std::vector<LinearBVHNode>& nodes) -> f32
+        {
+            if (nodes.empty()) return 0.0f;
+
+            f32 rootArea = nodes[0].bounds.SurfaceArea();
+            if (rootArea <= 0.0f) return 0.0f;
+
+            f32 cost = 0.0f;
+            for (const auto& node : nodes) {
+                f32 area = node.bounds.SurfaceArea() / rootArea;
+                if (node.nPrimitives > 0) {
+                    cost += area * IntersectCost * static_cast<f32>(node.nPrimitives);
+                } else {
+                    cost += area * TraversalCost;
+                }
+            }
+
+            return cost;
+        }
+
+        // Builds the linear tree and fills every stat but the build time; primitives end up in leaf order
+        auto BuildNodes(std::vector<BVHPrimitive>& primitives, const BVHBuildOptions& options, BVH::Stats& stats) -> std::vector<LinearBVHNode>
+        {
+            std::vector<LinearBVHNode> linearNodes;
+            u32 totalNodes = 0;
+            u32 totalLeaves = 0;
+            u32 maxDepth = 0;
+
+            if (options.SplitMethod == BVHSplitMethod::LBVH) {
+                LBVHBuilder builder(primitives);
+                builder.Build(linearNodes);
+
+                totalNodes = static_cast<u32>(linearNodes.size());
+                totalLeaves = static_cast<u32>(primitives.size());
+                maxDepth = builder.GetMaxDepth();
+            } else {
+                BVHBuilder builder(primitives, options);
+                const BVHBuildNode* root = builder.Build();
+
+                totalNodes = builder.GetTotalNodes();
+                totalLeaves = builder.GetTotalLeaves();
+                maxDepth = builder.GetMaxDepth();
+
+                linearNodes.resize(totalNodes);
+                FlattenBVHTree(root, linearNodes, 0, 0, builder.GetMaxTaskDepth());
+            }
+
+            f32 initialSAHCost = ComputeSAHCost(linearNodes);
+            f32 sahCost = initialSAHCost;
+
+            if (options.TreeletPasses > 0) {
+                OptimizeTreelets(linearNodes, options.TreeletPasses, TraversalCost, IntersectCost);
+
+                sahCost = ComputeSAHCost(linearNodes);
+                maxDepth = ComputeTreeDepth(linearNodes);
+            }
+
+            stats = BVH::Stats {
+                .TotalHittables = static_cast<u32>(primitives.size()),
+                .InternalNodes = totalNodes,
+                .LeafNodes = totalLeaves,
+                .TreeDepth = maxDepth,
+                .SAHCost = sahCost,
+                .InitialSAHCost = initialSAHCost,
+                .NodeMemory = linearNodes.size() * sizeof(LinearBVHNode)
+            };
+
+            return linearNodes;
+        }
+
+        auto LogBuildMetrics(const BVH::Stats& stats, const BVHBuildOptions& options) -> void
+        {
+            KINFO("BVH Construction Metrics");
+            KINFO(" - Split Method: {}", SplitMethodName(options.SplitMethod));
+            KINFO(" - Total Hittables: {}", stats.TotalHittables);
+            KINFO(" - Internal Nodes: {}", stats.InternalNodes);
+            KINFO(" - Leaf Nodes: {}", stats.LeafNodes);
+            KINFO(" - Max Tree Depth: {}", stats.TreeDepth);
+            if (options.TreeletPasses > 0) {
+                KINFO(" - SAH Cost: {:.3f} -> {:.3f} ({} treelet passes)", stats.InitialSAHCost, stats.SAHCost, options.TreeletPasses);
+            } else {
+                KINFO(" - SAH Cost: {:.3f}", stats.SAHCost);
+            }
+            KINFO(" - Build Time: {:.2f} ms", stats.BuildTime);
+            KINFO(" - Node Memory: {:.2f} KB", static_cast<f32>(stats.NodeMemory) / 1024.0f);
+        }
     
     }
 
     BVH::BVH(std::vector<std::shared_ptr<Hittable>>&& primitives, std::vector<LinearBVHNode>&& nodes, const Stats& stats)
         : m_Hittables(std::move(primitives)), m_Nodes(std::move(nodes)), m_Stats(stats)
     {
+        m_Spheres = SphereSoA::Gather(m_Hittables);
     }
 
-    auto BVH::Hit(const Ray& ray, Interval clip) const -> std::optional<HitRecord>
+    BVH::BVH(Scene& scene, std::vector<LinearBVHNode>&& nodes, const Stats& stats)
+        : m_Nodes(std::move(nodes)), m_Scene(&scene), m_Stats(stats)
+    {
+    }
+
+    auto BVH::Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit>
     {
         if (m_Nodes.empty()) return std::nullopt;
 
-        bool hitAnything = false;
+        std::optional<PrimitiveHit> closest;
 
-        const glm::vec3& invDir = 1.0f / ray.direction;
-        u32 dirIsNeg[3] = { invDir.x < 0, invDir.y < 0, invDir.z < 0 };
+        const RayQuery query(ray);
 
         u32 toVisitOffset = 0;
         u32 currentNodeIndex = 0;
         u32 nodesToVisit[64];
 
-        HitRecord record;
+        const SphereSoA& spheres = GetSpheres();
+        const bool packedSpheres = !spheres.Empty();
+        u32 closestSphere = 0;
 
         while (true) {
             const LinearBVHNode& node = m_Nodes[currentNodeIndex];
 
-            if (node.bounds.Hit(ray, clip)) {
+            if (node.bounds.Hit(query, clip)) {
+                if (node.nPrimitives > 0 && packedSpheres) {
+                    if (auto t = spheres.Intersect(ray, node.primitivesOffset, node.nPrimitives, clip, closestSphere)) {
+                        closest = PrimitiveHit { .t = *t, .primitive = closestSphere };
+                        clip.max = *t;
+                    }
+                    if (toVisitOffset == 0) break;
+                    currentNodeIndex = nodesToVisit[--toVisitOffset];
+                } else if (node.nPrimitives > 0) {
+                    for (u32 i = node.primitivesOffset; i < node.primitivesOffset + node.nPrimitives; ++i) {
+                        if (auto hit = m_Hittables[i]->Intersect(ray, clip)) {
+                            closest = PrimitiveHit { .t = hit->t, .primitive = i, .subPrimitive = hit->primitive };
+                            clip.max = hit->t;
+                        }
+                    }
+                    if (toVisitOffset == 0) break;
+                    currentNodeIndex = nodesToVisit[--toVisitOffset];
+                } else {
+                    if (query.dirIsNeg[node.axis]) {
+                        nodesToVisit[toVisitOffset++] = currentNodeIndex + 1;
+                        currentNodeIndex = node.secondChildOffset;
+                    } else {
+                        nodesToVisit[toVisitOffset++] = node.secondChildOffset;
+                        currentNodeIndex = currentNodeIndex + 1;
+                    }
+                }
+            } else {
+                if (toVisitOffset == 0) break;
+                currentNodeIndex = nodesToVisit[--toVisitOffset];
+            }
+        }
+
+        return closest;
+    }
+
+    auto BVH::Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction
+    {
+        const SphereSoA& spheres = GetSpheres();
+        if (!spheres.Empty()) return spheres.Interact(ray, hit);
+
+        // Only two levels are tracked: the primitive's own index is handed down, anything below it is dropped
+        return m_Hittables[hit.primitive]->Interact(ray, PrimitiveHit { .t = hit.t, .primitive = hit.subPrimitive });
+    }
+
+    auto BVH::Occluded(const Ray& ray, Interval clip) const -> bool
+    {
+        if (m_Nodes.empty()) return false;
+
+        const RayQuery query(ray);
+
+        u32 toVisitOffset = 0;
+        u32 currentNodeIndex = 0;
+        u32 nodesToVisit[64];
+
+        const SphereSoA& spheres = GetSpheres();
+        const bool packedSpheres = !spheres.Empty();
+
+        while (true) {
+            const LinearBVHNode& node = m_Nodes[currentNodeIndex];
+
+            if (node.bounds.Hit(query, clip)) {
                 if (node.nPrimitives > 0) {
-                    for (u32 i = 0; i < node.nPrimitives; ++i) {
-                        if (auto hit = m_Hittables[node.primitivesOffset + i]->Hit(ray, clip)) {
-                            hitAnything = true;
-                            record = *hit;
-                            clip.max = record.t;
+                    if (packedSpheres) {
+                        if (spheres.Occluded(ray, node.primitivesOffset, node.nPrimitives, clip)) return true;
+                    } else {
+                        for (u32 i = 0; i < node.nPrimitives; ++i) {
+                            if (m_Hittables[node.primitivesOffset + i]->Occluded(ray, clip)) return true;
                         }
                     }
                     if (toVisitOffset == 0) break;
                     currentNodeIndex = nodesToVisit[--toVisitOffset];
                 } else {
-                    if (dirIsNeg[node.axis]) {
+                    if (query.dirIsNeg[node.axis]) {
+                        nodesToVisit[toVisitOffset++] = currentNodeIndex + 1;
+                        currentNodeIndex = node.secondChildOffset;
+                    } else {
+                        nodesToVisit[toVisitOffset++] = node.secondChildOffset;
+                        currentNodeIndex = currentNodeIndex + 1;
+                    }
+                }
+            } else {
+                if (toVisitOffset == 0) break;
+                currentNodeIndex = nodesToVisit[--toVisitOffset];
+            }
+        }
+
+        return false;
+    }
+
+    template <usize N>
+    auto BVH::HitPacket(RayPacket<N>& packet, Interval clip, std::array<std::optional<SurfaceInteraction>, N>& hits) const -> void
+    {
+        hits.fill(std::nullopt);
+        if (m_Nodes.empty()) return;
+
+        // Packets rely on the packed sphere leaves; anything else is traced one lane at a time
+        const SphereSoA& spheres = GetSpheres();
+        if (spheres.Empty()) {
+            for (u32 lane = 0; lane < N; ++lane) {
+                if (packet.activeMask & (1u << lane)) {
+                    hits[lane] = Hit(packet.GetRay(lane), clip);
+                }
+            }
+            return;
+        }
+
+        for (u32 lane = 0; lane < N; ++lane) {
+            if (packet.activeMask & (1u << lane)) {
+                packet.tMax[lane] = std::min(packet.tMax[lane], clip.max);
+            }
+        }
+
+        u32 hitMask = 0;
+
+        u32 toVisitOffset = 0;
+        u32 currentNodeIndex = 0;
+        u32 nodesToVisit[64];
+
+        while (true) {
+            const LinearBVHNode& node = m_Nodes[currentNodeIndex];
+
+            u32 laneMask = IntersectBoxPacket(node.bounds, packet, clip.min, packet.activeMask);
+            if (laneMask != 0) {
+                if (node.nPrimitives > 0) {
+                    hitMask |= spheres.IntersectPacket(packet, node.primitivesOffset, node.nPrimitives, clip.min, laneMask);
+                    if (toVisitOffset == 0) break;
+                    currentNodeIndex = nodesToVisit[--toVisitOffset];
+                } else {
+                    // The first lane still inside the node decides the near child for the whole packet
+                    u32 lead = static_cast<u32>(std::countr_zero(laneMask));
+                    const f32 invDir[3] = { packet.invDirX[lead], packet.invDirY[lead], packet.invDirZ[lead] };
+
+                    if (invDir[node.axis] < 0.0f) {
                         nodesToVisit[toVisitOffset++] = currentNodeIndex + 1;
                         currentNodeIndex = node.secondChildOffset;
                     } else {
@@ -179,43 +921,151 @@ namespace Kyber {
             }
         }
 
-        if (hitAnything) {
-            return record;
+        while (hitMask) {
+            u32 lane = static_cast<u32>(std::countr_zero(hitMask));
+            hitMask &= hitMask - 1;
+
+            hits[lane] = spheres.Interact(packet.GetRay(lane), PrimitiveHit { .t = packet.tMax[lane], .primitive = packet.primitive[lane] });
+        }
+    }
+
+    template auto BVH::HitPacket<4>(RayPacket<4>&, Interval, std::array<std::optional<SurfaceInteraction>, 4>&) const -> void;
+    template auto BVH::HitPacket<8>(RayPacket<8>&, Interval, std::array<std::optional<SurfaceInteraction>, 8>&) const -> void;
+    template auto BVH::HitPacket<16>(RayPacket<16>&, Interval, std::array<std::optional<SurfaceInteraction>, 16>&) const -> void;
+
+    auto BVH::Rebuild() -> void
+    {
+        auto rebuilt = m_Scene ? Create(*m_Scene, m_Options) : Create(std::move(m_Hittables), m_Options);
+        if (!rebuilt) return;
+
+        m_Hittables = std::move(rebuilt->m_Hittables);
+        m_Nodes = std::move(rebuilt->m_Nodes);
+        m_Spheres = std::move(rebuilt->m_Spheres);
+        m_BuildSAHCost = rebuilt->m_BuildSAHCost;
+        m_Stats = rebuilt->m_Stats;
+    }
+
+    auto BVH::Refit(f32 rebuildThreshold) -> bool
+    {
+        if (m_Nodes.empty()) return false;
+
+        auto refitStart = std::chrono::steady_clock::now();
+
+        auto primitiveBounds = [this](u32 index) -> AABB {
+            return m_Scene ? m_Scene->GetSpheres().GetBBox(index) : m_Hittables[index]->GetBBox();
+        };
+
+        // Children are stored after their parent, so a reverse sweep visits them first
+        if (m_Nodes.size() < 2 * ParallelTaskThreshold) {
+            for (u32 i = static_cast<u32>(m_Nodes.size()); i-- > 0;) {
+                RefitNode(m_Nodes, i, primitiveBounds);
+            }
         } else {
-            return std::nullopt;
+            u32 workers = std::max(1u, std::thread::hardware_concurrency());
+            u32 maxDepth = static_cast<u32>(std::bit_width(workers)) + 2;
+
+            std::vector<std::pair<u32, u32>> ranges;
+            std::vector<u32> topNodes;
+            CollectRefitRanges(m_Nodes, 0, 0, maxDepth, ranges, topNodes);
+
+            std::for_each(std::execution::par, ranges.begin(), ranges.end(), [&](const std::pair<u32, u32>& range) {
+                for (u32 i = range.second; i-- > range.first;) {
+                    RefitNode(m_Nodes, i, primitiveBounds);
+                }
+            });
+
+            for (auto it = topNodes.rbegin(); it != topNodes.rend(); ++it) {
+                RefitNode(m_Nodes, *it, primitiveBounds);
+            }
         }
+
+        if (!m_Scene) {
+            m_Spheres = SphereSoA::Gather(m_Hittables);
+        }
+
+        f32 sahCost = ComputeSAHCost(m_Nodes);
+
+        std::chrono::duration<f32, std::milli> refitTime = std::chrono::steady_clock::now() - refitStart;
+
+        if (m_BuildSAHCost > 0.0f && sahCost > rebuildThreshold * m_BuildSAHCost) {
+            KINFO("BVH refit degraded SAH cost {:.3f} -> {:.3f}, rebuilding", m_BuildSAHCost, sahCost);
+            Rebuild();
+            return true;
+        }
+
+        m_Stats.SAHCost = sahCost;
+        m_Stats.RefitTime = refitTime.count();
+
+        return false;
     }
 
-    auto BVH::Create(std::vector<std::shared_ptr<Hittable>>&& primitives) -> std::unique_ptr<BVH>
+    auto BVH::Create(std::vector<std::shared_ptr<Hittable>>&& primitives, const BVHBuildOptions& options) -> std::unique_ptr<BVH>
     {
         if (primitives.empty()) return nullptr;
 
-        u32 maxDepth = 0;
-        u32 totalNodes = 0;
-        u32 totalLeaves = 0;
+        auto buildStart = std::chrono::steady_clock::now();
 
-        BVHBuildNode* root = BuildBVHRecursive(primitives, 0, static_cast<u32>(primitives.size()), totalNodes, totalLeaves, 0, maxDepth);
+        std::vector<BVHPrimitive> buildPrimitives(primitives.size());
+        std::for_each(std::execution::par, buildPrimitives.begin(), buildPrimitives.end(), [&](BVHPrimitive& primitive) {
+            u32 index = static_cast<u32>(&primitive - buildPrimitives.data());
+            AABB bounds = primitives[index]->GetBBox();
+            primitive = { bounds, GetCentroid(bounds), index };
+        });
 
-        std::vector<LinearBVHNode> linearNodes;
-        linearNodes.reserve(totalNodes);
-        FlattenBVHTree(root, linearNodes);
+        Stats stats;
+        std::vector<LinearBVHNode> linearNodes = BuildNodes(buildPrimitives, options, stats);
 
-        DeleteBVHBuildNode(root);
+        std::vector<std::shared_ptr<Hittable>> orderedPrimitives(primitives.size());
+        std::for_each(std::execution::par, buildPrimitives.begin(), buildPrimitives.end(), [&](const BVHPrimitive& primitive) {
+            usize slot = static_cast<usize>(&primitive - buildPrimitives.data());
+            orderedPrimitives[slot] = std::move(primitives[primitive.index]);
+        });
 
-        KINFO("BVH Construction Metrics");
-        KINFO(" - Total Hittables: {}", primitives.size());
-        KINFO(" - Internal Nodes: {}", totalNodes);
-        KINFO(" - Leaf Nodes: {}", totalLeaves);
-        KINFO(" - Max Tree Depth: {}", maxDepth);
+        std::chrono::duration<f32, std::milli> buildTime = std::chrono::steady_clock::now() - buildStart;
+        stats.BuildTime = buildTime.count();
 
-        Stats stats {
-            .TotalHittables = static_cast<u32>(primitives.size()),
-            .InternalNodes = totalNodes,
-            .LeafNodes = totalLeaves,
-            .TreeDepth = maxDepth
-        };
+        LogBuildMetrics(stats, options);
+
+        auto bvh = std::make_unique<BVH>(std::move(orderedPrimitives), std::move(linearNodes), stats);
+        bvh->m_Options = options;
+        bvh->m_BuildSAHCost = stats.SAHCost;
+
+        return bvh;
+    }
+
+    auto BVH::Create(Scene& scene, const BVHBuildOptions& options) -> std::unique_ptr<BVH>
+    {
+        const SphereSoA& spheres = scene.GetSpheres();
+        if (spheres.Empty()) return nullptr;
+
+        auto buildStart = std::chrono::steady_clock::now();
+
+        std::vector<BVHPrimitive> buildPrimitives(spheres.Size());
+        std::for_each(std::execution::par, buildPrimitives.begin(), buildPrimitives.end(), [&](BVHPrimitive& primitive) {
+            u32 index = static_cast<u32>(&primitive - buildPrimitives.data());
+            AABB bounds = spheres.GetBBox(index);
+            primitive = { bounds, GetCentroid(bounds), index };
+        });
+
+        Stats stats;
+        std::vector<LinearBVHNode> linearNodes = BuildNodes(buildPrimitives, options, stats);
+
+        std::vector<u32> order(buildPrimitives.size());
+        std::transform(std::execution::par, buildPrimitives.begin(), buildPrimitives.end(), order.begin(), [](const BVHPrimitive& primitive) {
+            return primitive.index;
+        });
+        scene.PermuteSpheres(order);
+
+        std::chrono::duration<f32, std::milli> buildTime = std::chrono::steady_clock::now() - buildStart;
+        stats.BuildTime = buildTime.count();
+
+        LogBuildMetrics(stats, options);
+
+        auto bvh = std::make_unique<BVH>(scene, std::move(linearNodes), stats);
+        bvh->m_Options = options;
+        bvh->m_BuildSAHCost = stats.SAHCost;
 
-        return std::make_unique<BVH>(std::move(primitives), std::move(linearNodes), stats);
+        return bvh;
     }
 
 }
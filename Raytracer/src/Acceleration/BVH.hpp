@@ -1,10 +1,30 @@
 #pragma once
 
 #include "Hittables/Hittable.hpp"
+#include "Scene.hpp"
+
+#include "SphereSoA.hpp"
 
 namespace Kyber {
 
-    struct LinearBVHNode
+    enum class BVHSplitMethod : u8
+    {
+        Median,
+        SAH,
+        LBVH
+    };
+
+    struct BVHBuildOptions
+    {
+        BVHSplitMethod SplitMethod { BVHSplitMethod::SAH };
+        u32 BinCount { 16 };
+        u32 MaxLeafPrimitives { 8 };
+
+        // Treelet restructuring passes run after the build; 0 disables the optimization
+        u32 TreeletPasses { 0 };
+    };
+
+    struct alignas(32) LinearBVHNode
     {
         AABB bounds;
         union {
@@ -16,6 +36,8 @@ namespace Kyber {
         u8 pad;
     };
 
+    static_assert(sizeof(LinearBVHNode) == 32);
+
     class BVH final : public Hittable
     {
     public:
@@ -25,25 +47,60 @@ namespace Kyber {
             u32 InternalNodes { 0 };
             u32 LeafNodes { 0 };
             u32 TreeDepth { 0 };
+            f32 SAHCost { 0.0f };
+            f32 InitialSAHCost { 0.0f };
+            f32 BuildTime { 0.0f };
+            f32 RefitTime { 0.0f };
+            usize NodeMemory { 0 };
         };
 
     public:
-        static auto Create(std::vector<std::shared_ptr<Hittable>>&& primitives) -> std::unique_ptr<BVH>;
+        static auto Create(std::vector<std::shared_ptr<Hittable>>&& primitives, const BVHBuildOptions& options = {}) -> std::unique_ptr<BVH>;
+
+        // Builds over the scene's sphere arrays, reordering them into leaf order. The scene must outlive the BVH.
+        static auto Create(Scene& scene, const BVHBuildOptions& options = {}) -> std::unique_ptr<BVH>;
 
         BVH() = default;
         BVH(std::vector<std::shared_ptr<Hittable>>&& primitives, std::vector<LinearBVHNode>&& nodes, const Stats& stats);
+        BVH(Scene& scene, std::vector<LinearBVHNode>&& nodes, const Stats& stats);
 
         virtual ~BVH() = default;
 
+        // Rebuilds the tree over the same primitives, e.g. after instance transforms change
+        auto Rebuild() -> void;
+
+        // Recomputes node bounds from the current primitive bounds, keeping the topology. Falls back
+        // to a rebuild once the SAH cost exceeds rebuildThreshold times the cost at build time.
+        // Returns true if the tree was rebuilt.
+        auto Refit(f32 rebuildThreshold = 1.5f) -> bool;
+
         virtual AABB GetBBox() const override { return m_Nodes.empty() ? AABB() : m_Nodes[0].bounds; }
-        virtual auto Hit(const Ray& ray, Interval clip) const -> std::optional<HitRecord> override;
+        virtual auto Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit> override;
+        virtual auto Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction override;
+        virtual auto Occluded(const Ray& ray, Interval clip) const -> bool override;
+
+        // Closest hit for every active lane of a coherent packet, sharing one traversal stack
+        template <usize N>
+        auto HitPacket(RayPacket<N>& packet, Interval clip, std::array<std::optional<SurfaceInteraction>, N>& hits) const -> void;
 
         auto GetStats() const -> Stats { return m_Stats; }
 
+        auto GetNodes() const -> const std::vector<LinearBVHNode>& { return m_Nodes; }
+        auto GetPrimitives() const -> const std::vector<std::shared_ptr<Hittable>>& { return m_Hittables; }
+        auto GetSpheres() const -> const SphereSoA& { return m_Scene ? m_Scene->GetSpheres() : m_Spheres; }
+        auto GetScene() const -> const Scene* { return m_Scene; }
+
     private:
         std::vector<std::shared_ptr<Hittable>> m_Hittables;
         std::vector<LinearBVHNode> m_Nodes;
 
+        // Leaves index the scene's arrays when built over a Scene, otherwise spheres gathered from the Hittables
+        Scene* m_Scene { nullptr };
+        SphereSoA m_Spheres;
+
+        BVHBuildOptions m_Options;
+        f32 m_BuildSAHCost { 0.0f };
+
         Stats m_Stats;
     };
 
@@ -0,0 +1,364 @@
+#include "SphereSoA.hpp"
+
+#include "Core/SIMD.hpp"
+#include "Hittables/Sphere.hpp"
+
+namespace Kyber {
+
+    namespace {
+
+#if KYBER_SIMD_SSE
+        struct RayLanes
+        {
+            __m128 ox, oy, oz;
+            __m128 dx, dy, dz;
+            __m128 fourA;
+            __m128 twoA;
+            __m128 clipMin;
+
+            RayLanes(const Ray& ray, f32 a, f32 tMin)
+                : ox(_mm_set1_ps(ray.origin.x)), oy(_mm_set1_ps(ray.origin.y)), oz(_mm_set1_ps(ray.origin.z))
+                , dx(_mm_set1_ps(ray.direction.x)), dy(_mm_set1_ps(ray.direction.y)), dz(_mm_set1_ps(ray.direction.z))
+                , fourA(_mm_set1_ps(4.0f * a)), twoA(_mm_set1_ps(2.0f * a))
+                , clipMin(_mm_set1_ps(tMin))
+            {
+            }
+        };
+
+        // Intersects four consecutive spheres, returning the lanes with a root inside (clip.min, tMax)
+        auto IntersectLanes(const RayLanes& lanes, const f32* cx, const f32* cy, const f32* cz, const f32* radius, f32 tMax, f32* roots) -> u32
+        {
+            const __m128 zero = _mm_setzero_ps();
+
+            const __m128 ocx = _mm_sub_ps(lanes.ox, _mm_loadu_ps(cx));
+            const __m128 ocy = _mm_sub_ps(lanes.oy, _mm_loadu_ps(cy));
+            const __m128 ocz = _mm_sub_ps(lanes.oz, _mm_loadu_ps(cz));
+            const __m128 r = _mm_loadu_ps(radius);
+
+            const __m128 halfB = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, lanes.dx), _mm_mul_ps(ocy, lanes.dy)), _mm_mul_ps(ocz, lanes.dz));
+            const __m128 b = _mm_add_ps(halfB, halfB);
+            const __m128 c = _mm_sub_ps(
+                _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, ocx), _mm_mul_ps(ocy, ocy)), _mm_mul_ps(ocz, ocz)),
+                _mm_mul_ps(r, r)
+            );
+
+            const __m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(lanes.fourA, c));
+            const __m128 valid = _mm_cmpge_ps(discriminant, zero);
+            if (_mm_movemask_ps(valid) == 0) return 0;
+
+            const __m128 sqrtd = _mm_sqrt_ps(_mm_max_ps(discriminant, zero));
+            const __m128 clipMax = _mm_set1_ps(tMax);
+
+            const __m128 near = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(zero, b), sqrtd), lanes.twoA);
+            const __m128 far = _mm_div_ps(_mm_add_ps(_mm_sub_ps(zero, b), sqrtd), lanes.twoA);
+
+            const __m128 nearOk = _mm_and_ps(_mm_cmpgt_ps(near, lanes.clipMin), _mm_cmplt_ps(near, clipMax));
+            const __m128 farOk = _mm_and_ps(_mm_cmpgt_ps(far, lanes.clipMin), _mm_cmplt_ps(far, clipMax));
+
+            _mm_storeu_ps(roots, _mm_or_ps(_mm_and_ps(nearOk, near), _mm_andnot_ps(nearOk, far)));
+
+            return static_cast<u32>(_mm_movemask_ps(_mm_and_ps(valid, _mm_or_ps(nearOk, farOk))));
+        }
+#endif
+
+        auto LaneMask(u32 remaining) -> u32
+        {
+            return remaining >= SphereSoA::LaneWidth ? 0xFu : ((1u << remaining) - 1u);
+        }
+
+    }
+
+    SphereSoA::SphereSoA(std::pmr::memory_resource* resource)
+        : m_CenterX(resource)
+        , m_CenterY(resource)
+        , m_CenterZ(resource)
+        , m_Radius(resource)
+        , m_Material(resource)
+    {
+    }
+
+    auto SphereSoA::Gather(std::span<const std::shared_ptr<Hittable>> primitives) -> SphereSoA
+    {
+        SphereSoA soa;
+        soa.Reserve(primitives.size());
+
+        for (const auto& primitive : primitives) {
+            const Sphere* sphere = dynamic_cast<const Sphere*>(primitive.get());
+            if (!sphere) return {};
+
+            soa.Push(sphere->GetCenter(), sphere->GetRadius(), sphere->GetMaterial());
+        }
+
+        return soa;
+    }
+
+    auto SphereSoA::Reserve(usize capacity) -> void
+    {
+        m_CenterX.reserve(capacity + LaneWidth - 1);
+        m_CenterY.reserve(capacity + LaneWidth - 1);
+        m_CenterZ.reserve(capacity + LaneWidth - 1);
+        m_Radius.reserve(capacity + LaneWidth - 1);
+        m_Material.reserve(capacity);
+    }
+
+    auto SphereSoA::Push(const glm::vec3& center, f32 radius, u32 material) -> void
+    {
+        usize index = m_Material.size();
+
+        // Growing by one keeps the padding entries zeroed behind the new sphere
+        m_CenterX.resize(index + LaneWidth, 0.0f);
+        m_CenterY.resize(index + LaneWidth, 0.0f);
+        m_CenterZ.resize(index + LaneWidth, 0.0f);
+        m_Radius.resize(index + LaneWidth, 0.0f);
+
+        m_CenterX[index] = center.x;
+        m_CenterY[index] = center.y;
+        m_CenterZ[index] = center.z;
+        m_Radius[index] = std::max(radius, 0.0f);
+        m_Material.push_back(material);
+    }
+
+    auto SphereSoA::Permute(std::span<const u32> order) -> void
+    {
+        // One scratch array at a time keeps the peak overhead to a single column
+        auto permute = [&]<typename T>(std::pmr::vector<T>& column) {
+            std::vector<T> scratch(order.size());
+            std::for_each(std::execution::par, order.begin(), order.end(), [&](const u32& source) {
+                scratch[static_cast<usize>(&source - order.data())] = column[source];
+            });
+            std::copy(scratch.begin(), scratch.end(), column.begin());
+        };
+
+        permute(m_CenterX);
+        permute(m_CenterY);
+        permute(m_CenterZ);
+        permute(m_Radius);
+        permute(m_Material);
+    }
+
+    auto SphereSoA::GetBBox(u32 index) const -> AABB
+    {
+        glm::vec3 center(m_CenterX[index], m_CenterY[index], m_CenterZ[index]);
+        glm::vec3 rvec(m_Radius[index]);
+        return AABB(center - rvec, center + rvec);
+    }
+
+    auto SphereSoA::Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction
+    {
+        const u32 i = hit.primitive;
+        const glm::vec3 center(m_CenterX[i], m_CenterY[i], m_CenterZ[i]);
+
+        SurfaceInteraction interaction;
+        interaction.t = hit.t;
+        interaction.p = ray.At(hit.t);
+        interaction.SetFaceNormal(ray, (interaction.p - center) / m_Radius[i]);
+        interaction.material = m_Material[i];
+
+        return interaction;
+    }
+
+    auto SphereSoA::GetMemoryUsage() const -> usize
+    {
+        return (m_CenterX.capacity() + m_CenterY.capacity() + m_CenterZ.capacity() + m_Radius.capacity()) * sizeof(f32)
+            + m_Material.capacity() * sizeof(u32);
+    }
+
+    auto SphereSoA::Intersect(const Ray& ray, u32 first, u32 count, const Interval& clip, u32& hitIndex) const -> std::optional<f32>
+    {
+        f32 closest = clip.max;
+        bool hitAnything = false;
+
+        const f32 a = glm::dot(ray.direction, ray.direction);
+
+#if KYBER_SIMD_SSE
+        const RayLanes lanes(ray, a, clip.min);
+
+        for (u32 group = 0; group < count; group += LaneWidth) {
+            u32 base = first + group;
+
+            alignas(16) f32 roots[LaneWidth];
+            u32 mask = IntersectLanes(lanes, &m_CenterX[base], &m_CenterY[base], &m_CenterZ[base], &m_Radius[base], closest, roots);
+            mask &= LaneMask(count - group);
+
+            while (mask) {
+                u32 lane = static_cast<u32>(std::countr_zero(mask));
+                mask &= mask - 1;
+
+                if (roots[lane] < closest) {
+                    closest = roots[lane];
+                    hitIndex = base + lane;
+                    hitAnything = true;
+                }
+            }
+        }
+#else
+        for (u32 i = first; i < first + count; ++i) {
+            glm::vec3 oc = ray.origin - glm::vec3(m_CenterX[i], m_CenterY[i], m_CenterZ[i]);
+
+            f32 b = 2.0f * glm::dot(oc, ray.direction);
+            f32 c = glm::dot(oc, oc) - m_Radius[i] * m_Radius[i];
+
+            f32 discriminant = b * b - 4.0f * a * c;
+            if (discriminant < 0.0f) continue;
+
+            f32 sqrtd = glm::sqrt(discriminant);
+            f32 root = (-b - sqrtd) / (2.0f * a);
+
+            if (!(root > clip.min && root < closest)) {
+                root = (-b + sqrtd) / (2.0f * a);
+                if (!(root > clip.min && root < closest)) continue;
+            }
+
+            closest = root;
+            hitIndex = i;
+            hitAnything = true;
+        }
+#endif
+
+        if (hitAnything) {
+            return closest;
+        } else {
+            return std::nullopt;
+        }
+    }
+
+    auto SphereSoA::Occluded(const Ray& ray, u32 first, u32 count, const Interval& clip) const -> bool
+    {
+        const f32 a = glm::dot(ray.direction, ray.direction);
+
+#if KYBER_SIMD_SSE
+        const RayLanes lanes(ray, a, clip.min);
+
+        for (u32 group = 0; group < count; group += LaneWidth) {
+            u32 base = first + group;
+
+            alignas(16) f32 roots[LaneWidth];
+            u32 mask = IntersectLanes(lanes, &m_CenterX[base], &m_CenterY[base], &m_CenterZ[base], &m_Radius[base], clip.max, roots);
+            if (mask & LaneMask(count - group)) return true;
+        }
+#else
+        for (u32 i = first; i < first + count; ++i) {
+            glm::vec3 oc = ray.origin - glm::vec3(m_CenterX[i], m_CenterY[i], m_CenterZ[i]);
+
+            f32 b = 2.0f * glm::dot(oc, ray.direction);
+            f32 c = glm::dot(oc, oc) - m_Radius[i] * m_Radius[i];
+
+            f32 discriminant = b * b - 4.0f * a * c;
+            if (discriminant < 0.0f) continue;
+
+            f32 sqrtd = glm::sqrt(discriminant);
+            if (clip.Surrounds((-b - sqrtd) / (2.0f * a)) || clip.Surrounds((-b + sqrtd) / (2.0f * a))) return true;
+        }
+#endif
+
+        return false;
+    }
+
+    template <usize N>
+    auto SphereSoA::IntersectPacket(RayPacket<N>& packet, u32 first, u32 count, f32 tMin, u32 laneMask) const -> u32
+    {
+        u32 hitMask = 0;
+
+        for (u32 group = 0; group < RayPacket<N>::Groups; ++group) {
+            const u32 groupMask = (laneMask >> (group * 4)) & 0xFu;
+            if (groupMask == 0) continue;
+
+            const u32 lane0 = group * 4;
+
+#if KYBER_SIMD_SSE
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 clipMin = _mm_set1_ps(tMin);
+
+            const __m128 ox = _mm_load_ps(&packet.originX[lane0]);
+            const __m128 oy = _mm_load_ps(&packet.originY[lane0]);
+            const __m128 oz = _mm_load_ps(&packet.originZ[lane0]);
+
+            const __m128 dx = _mm_load_ps(&packet.directionX[lane0]);
+            const __m128 dy = _mm_load_ps(&packet.directionY[lane0]);
+            const __m128 dz = _mm_load_ps(&packet.directionZ[lane0]);
+
+            const __m128 a = _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)), _mm_mul_ps(dz, dz));
+            const __m128 fourA = _mm_mul_ps(_mm_set1_ps(4.0f), a);
+            const __m128 twoA = _mm_add_ps(a, a);
+
+            __m128 tMax = _mm_load_ps(&packet.tMax[lane0]);
+            __m128i primitive = _mm_load_si128(reinterpret_cast<const __m128i*>(&packet.primitive[lane0]));
+            u32 groupHits = 0;
+
+            for (u32 i = first; i < first + count; ++i) {
+                const __m128 ocx = _mm_sub_ps(ox, _mm_set1_ps(m_CenterX[i]));
+                const __m128 ocy = _mm_sub_ps(oy, _mm_set1_ps(m_CenterY[i]));
+                const __m128 ocz = _mm_sub_ps(oz, _mm_set1_ps(m_CenterZ[i]));
+                const __m128 r = _mm_set1_ps(m_Radius[i]);
+
+                const __m128 halfB = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, dx), _mm_mul_ps(ocy, dy)), _mm_mul_ps(ocz, dz));
+                const __m128 b = _mm_add_ps(halfB, halfB);
+                const __m128 c = _mm_sub_ps(
+                    _mm_add_ps(_mm_add_ps(_mm_mul_ps(ocx, ocx), _mm_mul_ps(ocy, ocy)), _mm_mul_ps(ocz, ocz)),
+                    _mm_mul_ps(r, r)
+                );
+
+                const __m128 discriminant = _mm_sub_ps(_mm_mul_ps(b, b), _mm_mul_ps(fourA, c));
+                const __m128 valid = _mm_cmpge_ps(discriminant, zero);
+                if (_mm_movemask_ps(valid) == 0) continue;
+
+                const __m128 sqrtd = _mm_sqrt_ps(_mm_max_ps(discriminant, zero));
+                const __m128 near = _mm_div_ps(_mm_sub_ps(_mm_sub_ps(zero, b), sqrtd), twoA);
+                const __m128 far = _mm_div_ps(_mm_add_ps(_mm_sub_ps(zero, b), sqrtd), twoA);
+
+                const __m128 nearOk = _mm_and_ps(_mm_cmpgt_ps(near, clipMin), _mm_cmplt_ps(near, tMax));
+                const __m128 farOk = _mm_and_ps(_mm_cmpgt_ps(far, clipMin), _mm_cmplt_ps(far, tMax));
+
+                const __m128 root = _mm_or_ps(_mm_and_ps(nearOk, near), _mm_andnot_ps(nearOk, far));
+                const __m128 hit = _mm_and_ps(valid, _mm_or_ps(nearOk, farOk));
+
+                const __m128i hitBits = _mm_castps_si128(hit);
+                tMax = _mm_or_ps(_mm_and_ps(hit, root), _mm_andnot_ps(hit, tMax));
+                primitive = _mm_or_si128(_mm_and_si128(hitBits, _mm_set1_epi32(static_cast<i32>(i))), _mm_andnot_si128(hitBits, primitive));
+                groupHits |= static_cast<u32>(_mm_movemask_ps(hit));
+            }
+
+            _mm_store_ps(&packet.tMax[lane0], tMax);
+            _mm_store_si128(reinterpret_cast<__m128i*>(&packet.primitive[lane0]), primitive);
+            hitMask |= (groupHits & groupMask) << lane0;
+#else
+            for (u32 lane = lane0; lane < lane0 + 4; ++lane) {
+                if (!(laneMask & (1u << lane))) continue;
+
+                const glm::vec3 origin(packet.originX[lane], packet.originY[lane], packet.originZ[lane]);
+                const glm::vec3 direction(packet.directionX[lane], packet.directionY[lane], packet.directionZ[lane]);
+                const f32 a = glm::dot(direction, direction);
+
+                for (u32 i = first; i < first + count; ++i) {
+                    glm::vec3 oc = origin - glm::vec3(m_CenterX[i], m_CenterY[i], m_CenterZ[i]);
+
+                    f32 b = 2.0f * glm::dot(oc, direction);
+                    f32 c = glm::dot(oc, oc) - m_Radius[i] * m_Radius[i];
+
+                    f32 discriminant = b * b - 4.0f * a * c;
+                    if (discriminant < 0.0f) continue;
+
+                    f32 sqrtd = glm::sqrt(discriminant);
+                    f32 root = (-b - sqrtd) / (2.0f * a);
+
+                    if (!(root > tMin && root < packet.tMax[lane])) {
+                        root = (-b + sqrtd) / (2.0f * a);
+                        if (!(root > tMin && root < packet.tMax[lane])) continue;
+                    }
+
+                    packet.tMax[lane] = root;
+                    packet.primitive[lane] = i;
+                    hitMask |= 1u << lane;
+                }
+            }
+#endif
+        }
+
+        return hitMask;
+    }
+
+    template auto SphereSoA::IntersectPacket<4>(RayPacket<4>&, u32, u32, f32, u32) const -> u32;
+    template auto SphereSoA::IntersectPacket<8>(RayPacket<8>&, u32, u32, f32, u32) const -> u32;
+    template auto SphereSoA::IntersectPacket<16>(RayPacket<16>&, u32, u32, f32, u32) const -> u32;
+
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "Hittables/Hittable.hpp"
+#include "Containers/RayPacket.hpp"
+
+namespace Kyber {
+
+    // Sphere centers, radii and materials packed in BVH leaf order, so a whole leaf is intersected without touching the Hittables
+    class SphereSoA
+    {
+    public:
+        static constexpr u32 LaneWidth = 4;
+
+    public:
+        static auto Gather(std::span<const std::shared_ptr<Hittable>> primitives) -> SphereSoA;
+
+        SphereSoA() = default;
+        explicit SphereSoA(std::pmr::memory_resource* resource);
+        ~SphereSoA() = default;
+
+        auto Empty() const -> bool { return m_Material.empty(); }
+        auto Size() const -> u32 { return static_cast<u32>(m_Material.size()); }
+
+        auto Reserve(usize capacity) -> void;
+        auto Push(const glm::vec3& center, f32 radius, u32 material) -> void;
+
+        // Reorders the spheres so that slot i holds the sphere previously at order[i]
+        auto Permute(std::span<const u32> order) -> void;
+
+        auto GetBBox(u32 index) const -> AABB;
+        auto Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction;
+
+        // Bytes held by the arrays, including reserved capacity
+        auto GetMemoryUsage() const -> usize;
+
+        // Closest sphere in [first, first + count) inside clip; returns its t and writes its index
+        auto Intersect(const Ray& ray, u32 first, u32 count, const Interval& clip, u32& hitIndex) const -> std::optional<f32>;
+
+        // True as soon as any sphere in [first, first + count) is hit inside clip
+        auto Occluded(const Ray& ray, u32 first, u32 count, const Interval& clip) const -> bool;
+
+        // Tests every sphere in the range against the packet lanes in laneMask, shrinking their tMax; returns the lanes that hit
+        template <usize N>
+        auto IntersectPacket(RayPacket<N>& packet, u32 first, u32 count, f32 tMin, u32 laneMask) const -> u32;
+
+    private:
+        // The float arrays carry LaneWidth - 1 zeroed entries past the last sphere so a group load never reads out of bounds
+        std::pmr::vector<f32> m_CenterX;
+        std::pmr::vector<f32> m_CenterY;
+        std::pmr::vector<f32> m_CenterZ;
+        std::pmr::vector<f32> m_Radius;
+        std::pmr::vector<u32> m_Material;
+    };
+
+}
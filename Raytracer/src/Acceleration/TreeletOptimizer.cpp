@@ -0,0 +1,291 @@
+#include "TreeletOptimizer.hpp"
+
+namespace Kyber {
+
+    namespace {
+
+        constexpr u32 TreeletLeaves = 7;
+        constexpr u32 TreeletSubsets = 1u << TreeletLeaves;
+        constexpr u32 InvalidNode = ~0u;
+
+        // Pointer-style view of the tree so topology can change in place; node ids are the original offsets
+        class TreeletOptimizer
+        {
+        public:
+            TreeletOptimizer(const std::vector<LinearBVHNode>& nodes, f32 traversalCost, f32 intersectCost)
+                : m_Nodes(nodes)
+                , m_TraversalCost(traversalCost)
+                , m_IntersectCost(intersectCost)
+                , m_Left(nodes.size(), InvalidNode)
+                , m_Right(nodes.size(), InvalidNode)
+                , m_Bounds(nodes.size())
+                , m_Cost(nodes.size(), 0.0f)
+                , m_Leaves(nodes.size(), 0)
+            {
+                for (u32 i = 0; i < nodes.size(); ++i) {
+                    m_Bounds[i] = nodes[i].bounds;
+                    if (nodes[i].nPrimitives == 0) {
+                        m_Left[i] = i + 1;
+                        m_Right[i] = nodes[i].secondChildOffset;
+                    }
+                }
+
+                // Children follow their parent in the input layout
+                for (u32 i = static_cast<u32>(nodes.size()); i-- > 0;) {
+                    UpdateNode(i);
+                }
+            }
+
+            auto Optimize() -> void
+            {
+                auto levels = CollectLevels();
+
+                // Roots on one level own disjoint subtrees, and deeper levels finish before their ancestors
+                for (auto level = levels.rbegin(); level != levels.rend(); ++level) {
+                    std::for_each(std::execution::par, level->begin(), level->end(), [this](u32 node) {
+                        if (m_Left[node] == InvalidNode) return;
+
+                        UpdateNode(node);
+                        if (m_Leaves[node] >= TreeletLeaves) {
+                            RestructureTreelet(node);
+                        }
+                    });
+                }
+            }
+
+            auto Flatten(std::vector<LinearBVHNode>& nodes) const -> void
+            {
+                // Subtree sizes give each child's depth-first offset
+                std::vector<u32> order;
+                order.reserve(m_Nodes.size());
+
+                std::vector<u32> stack { 0 };
+                while (!stack.empty()) {
+                    u32 node = stack.back();
+                    stack.pop_back();
+                    order.push_back(node);
+
+                    if (m_Left[node] != InvalidNode) {
+                        stack.push_back(m_Right[node]);
+                        stack.push_back(m_Left[node]);
+                    }
+                }
+
+                std::vector<u32> subtreeNodes(m_Nodes.size(), 1);
+                for (auto it = order.rbegin(); it != order.rend(); ++it) {
+                    if (m_Left[*it] != InvalidNode) {
+                        subtreeNodes[*it] = 1 + subtreeNodes[m_Left[*it]] + subtreeNodes[m_Right[*it]];
+                    }
+                }
+
+                std::vector<LinearBVHNode> flattened(order.size());
+                std::vector<std::pair<u32, u32>> pending { { 0, 0 } };
+
+                while (!pending.empty()) {
+                    auto [node, offset] = pending.back();
+                    pending.pop_back();
+
+                    LinearBVHNode& linearNode = flattened[offset];
+
+                    if (m_Left[node] == InvalidNode) {
+                        linearNode = m_Nodes[node];
+                        continue;
+                    }
+
+                    // Traversal expects the first child on the low side of the split axis
+                    u32 first = m_Left[node];
+                    u32 second = m_Right[node];
+
+                    glm::vec3 delta = Center(m_Bounds[second]) - Center(m_Bounds[first]);
+                    u32 axis = 0;
+                    if (std::abs(delta.y) > std::abs(delta[axis])) axis = 1;
+                    if (std::abs(delta.z) > std::abs(delta[axis])) axis = 2;
+
+                    if (delta[axis] < 0.0f) {
+                        std::swap(first, second);
+                    }
+
+                    u32 firstOffset = offset + 1;
+                    u32 secondOffset = firstOffset + subtreeNodes[first];
+
+                    linearNode.bounds = m_Bounds[node];
+                    linearNode.secondChildOffset = secondOffset;
+                    linearNode.nPrimitives = 0;
+                    linearNode.axis = static_cast<u8>(axis);
+                    linearNode.pad = 0;
+
+                    pending.emplace_back(second, secondOffset);
+                    pending.emplace_back(first, firstOffset);
+                }
+
+                nodes = std::move(flattened);
+            }
+
+        private:
+            static auto Center(const AABB& bounds) -> glm::vec3
+            {
+                return glm::vec3(bounds.x.min + bounds.x.max, bounds.y.min + bounds.y.max, bounds.z.min + bounds.z.max) * 0.5f;
+            }
+
+            auto CollectLevels() const -> std::vector<std::vector<u32>>
+            {
+                std::vector<std::vector<u32>> levels;
+                std::vector<std::pair<u32, u32>> stack { { 0, 0 } };
+
+                while (!stack.empty()) {
+                    auto [node, depth] = stack.back();
+                    stack.pop_back();
+
+                    if (levels.size() <= depth) levels.resize(depth + 1);
+                    levels[depth].push_back(node);
+
+                    if (m_Left[node] != InvalidNode) {
+                        stack.emplace_back(m_Left[node], depth + 1);
+                        stack.emplace_back(m_Right[node], depth + 1);
+                    }
+                }
+
+                return levels;
+            }
+
+            auto UpdateNode(u32 node) -> void
+            {
+                f32 area = m_Bounds[node].SurfaceArea();
+
+                if (m_Left[node] == InvalidNode) {
+                    m_Leaves[node] = 1;
+                    m_Cost[node] = m_IntersectCost * area * static_cast<f32>(m_Nodes[node].nPrimitives);
+                    return;
+                }
+
+                u32 left = m_Left[node];
+                u32 right = m_Right[node];
+
+                m_Bounds[node] = AABB(m_Bounds[left], m_Bounds[right]);
+                m_Leaves[node] = m_Leaves[left] + m_Leaves[right];
+                m_Cost[node] = m_TraversalCost * m_Bounds[node].SurfaceArea() + m_Cost[left] + m_Cost[right];
+            }
+
+            auto RestructureTreelet(u32 root) -> void
+            {
+                struct Treelet
+                {
+                    u32 leaves[TreeletLeaves];
+                    u32 internals[TreeletLeaves - 2];
+                    u32 leafCount { 0 };
+                    u32 internalCount { 0 };
+
+                    AABB bounds[TreeletSubsets];
+                    f32 cost[TreeletSubsets];
+                    u8 partition[TreeletSubsets];
+                } treelet;
+
+                // Grow the treelet by opening the largest-area internal node among its leaves
+                treelet.leaves[treelet.leafCount++] = m_Left[root];
+                treelet.leaves[treelet.leafCount++] = m_Right[root];
+
+                while (treelet.leafCount < TreeletLeaves) {
+                    u32 best = InvalidNode;
+                    f32 bestArea = -1.0f;
+
+                    for (u32 i = 0; i < treelet.leafCount; ++i) {
+                        u32 node = treelet.leaves[i];
+                        if (m_Left[node] == InvalidNode) continue;
+
+                        f32 area = m_Bounds[node].SurfaceArea();
+                        if (area > bestArea) {
+                            bestArea = area;
+                            best = i;
+                        }
+                    }
+
+                    if (best == InvalidNode) break;
+
+                    u32 opened = treelet.leaves[best];
+                    treelet.internals[treelet.internalCount++] = opened;
+                    treelet.leaves[best] = m_Left[opened];
+                    treelet.leaves[treelet.leafCount++] = m_Right[opened];
+                }
+
+                if (treelet.internalCount == 0) return;
+
+                // Optimal partition of every leaf subset, smaller subsets first
+                const u32 full = (1u << treelet.leafCount) - 1;
+
+                for (u32 subset = 1; subset <= full; ++subset) {
+                    if (std::has_single_bit(subset)) {
+                        u32 leaf = treelet.leaves[std::countr_zero(subset)];
+                        treelet.bounds[subset] = m_Bounds[leaf];
+                        treelet.cost[subset] = m_Cost[leaf];
+                        continue;
+                    }
+
+                    u32 lowest = subset & (~subset + 1);
+                    treelet.bounds[subset] = AABB(treelet.bounds[lowest], treelet.bounds[subset ^ lowest]);
+
+                    f32 bestCost = std::numeric_limits<f32>::infinity();
+                    u32 bestPartition = 0;
+
+                    // Keeping the lowest leaf on one side visits each unordered split once
+                    for (u32 part = (subset - 1) & subset; part != 0; part = (part - 1) & subset) {
+                        if (!(part & lowest)) continue;
+
+                        f32 cost = treelet.cost[part] + treelet.cost[subset ^ part];
+                        if (cost < bestCost) {
+                            bestCost = cost;
+                            bestPartition = part;
+                        }
+                    }
+
+                    treelet.cost[subset] = m_TraversalCost * treelet.bounds[subset].SurfaceArea() + bestCost;
+                    treelet.partition[subset] = static_cast<u8>(bestPartition);
+                }
+
+                if (treelet.cost[full] >= m_Cost[root] * (1.0f - 1e-5f)) return;
+
+                u32 nextInternal = 0;
+                auto emit = [&](auto& self, u32 subset) -> u32 {
+                    if (std::has_single_bit(subset)) {
+                        return treelet.leaves[std::countr_zero(subset)];
+                    }
+
+                    u32 node = (subset == full) ? root : treelet.internals[nextInternal++];
+                    u32 part = treelet.partition[subset];
+
+                    m_Left[node] = self(self, part);
+                    m_Right[node] = self(self, subset ^ part);
+                    UpdateNode(node);
+
+                    return node;
+                };
+
+                emit(emit, full);
+            }
+
+        private:
+            const std::vector<LinearBVHNode>& m_Nodes;
+            f32 m_TraversalCost;
+            f32 m_IntersectCost;
+
+            std::vector<u32> m_Left;
+            std::vector<u32> m_Right;
+            std::vector<AABB> m_Bounds;
+            std::vector<f32> m_Cost;
+            std::vector<u32> m_Leaves;
+        };
+
+    }
+
+    auto OptimizeTreelets(std::vector<LinearBVHNode>& nodes, u32 passes, f32 traversalCost, f32 intersectCost) -> void
+    {
+        if (nodes.size() < 3) return;
+
+        TreeletOptimizer optimizer(nodes, traversalCost, intersectCost);
+        for (u32 pass = 0; pass < passes; ++pass) {
+            optimizer.Optimize();
+        }
+
+        optimizer.Flatten(nodes);
+    }
+
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "BVH.hpp"
+
+namespace Kyber {
+
+    // Treelet restructuring in the style of Karras & Aila: every treelet of up to seven leaves is
+    // rebuilt with the topology that minimizes its SAH cost. Leaves keep their primitive ranges,
+    // and the result is flattened back into the depth-first layout.
+    auto OptimizeTreelets(std::vector<LinearBVHNode>& nodes, u32 passes, f32 traversalCost, f32 intersectCost) -> void;
+
+}
@@ -0,0 +1,518 @@
+#include "WideBVH.hpp"
+
+#include "Core/SIMD.hpp"
+
+namespace Kyber {
+
+    namespace {
+
+        constexpr u32 TraversalStackSize = 256;
+
+        struct StackEntry
+        {
+            u32 node;
+            f32 tNear;
+        };
+
+        struct ChildHit
+        {
+            f32 tNear;
+            u32 slot;
+        };
+
+        class WideBVHCollapser
+        {
+        public:
+            WideBVHCollapser(const std::vector<LinearBVHNode>& binary, std::vector<WideBVHNode>& nodes)
+                : m_Binary(binary), m_Nodes(nodes)
+            {
+            }
+
+            auto Collapse(std::span<const u32> slots, u32 depth) -> u32
+            {
+                m_MaxDepth = std::max(m_MaxDepth, depth);
+                m_TotalChildren += static_cast<u32>(slots.size());
+
+                u32 index = static_cast<u32>(m_Nodes.size());
+                m_Nodes.push_back({});
+
+                WideBVHNode wide {};
+                wide.childCount = static_cast<u32>(slots.size());
+
+                for (u32 i = 0; i < WideBVHNode::Width; ++i) {
+                    wide.children[i] = WideBVHNode::EmptySlot;
+                    wide.counts[i] = 0;
+                }
+
+                for (u32 i = 0; i < slots.size(); ++i) {
+                    const LinearBVHNode& child = m_Binary[slots[i]];
+
+                    wide.minX[i] = child.bounds.x.min;
+                    wide.minY[i] = child.bounds.y.min;
+                    wide.minZ[i] = child.bounds.z.min;
+                    wide.maxX[i] = child.bounds.x.max;
+                    wide.maxY[i] = child.bounds.y.max;
+                    wide.maxZ[i] = child.bounds.z.max;
+
+                    if (child.nPrimitives > 0) {
+                        wide.children[i] = child.primitivesOffset;
+                        wide.counts[i] = child.nPrimitives;
+                    } else {
+                        std::array<u32, WideBVHNode::Width> grandChildren;
+                        u32 count = GatherChildren(slots[i], grandChildren);
+                        wide.children[i] = Collapse(std::span<const u32>(grandChildren.data(), count), depth + 1);
+                    }
+                }
+
+                m_Nodes[index] = wide;
+                return index;
+            }
+
+            // Opens binary interior nodes, largest surface area first, until the slots are full
+            auto GatherChildren(u32 binaryIndex, std::array<u32, WideBVHNode::Width>& slots) const -> u32
+            {
+                u32 count = 0;
+                slots[count++] = binaryIndex + 1;
+                slots[count++] = m_Binary[binaryIndex].secondChildOffset;
+
+                while (count < WideBVHNode::Width) {
+                    i32 best = -1;
+                    f32 bestArea = -1.0f;
+
+                    for (u32 i = 0; i < count; ++i) {
+                        const LinearBVHNode& node = m_Binary[slots[i]];
+                        if (node.nPrimitives > 0) continue;
+
+                        f32 area = node.bounds.SurfaceArea();
+                        if (area > bestArea) {
+                            bestArea = area;
+                            best = static_cast<i32>(i);
+                        }
+                    }
+
+                    if (best < 0) break;
+
+                    u32 expand = slots[best];
+                    slots[best] = expand + 1;
+                    slots[count++] = m_Binary[expand].secondChildOffset;
+                }
+
+                return count;
+            }
+
+            auto GetMaxDepth() const -> u32 { return m_MaxDepth; }
+            auto GetTotalChildren() const -> u32 { return m_TotalChildren; }
+
+        private:
+            const std::vector<LinearBVHNode>& m_Binary;
+            std::vector<WideBVHNode>& m_Nodes;
+
+            u32 m_MaxDepth { 0 };
+            u32 m_TotalChildren { 0 };
+        };
+
+        auto IntersectChildren(const WideBVHNode& node, const RayQuery& query, const Interval& clip, f32* tNear) -> u32
+        {
+#if KYBER_SIMD_SSE
+            const __m128 ox = _mm_set1_ps(query.origin.x);
+            const __m128 oy = _mm_set1_ps(query.origin.y);
+            const __m128 oz = _mm_set1_ps(query.origin.z);
+
+            const __m128 ix = _mm_set1_ps(query.invDir.x);
+            const __m128 iy = _mm_set1_ps(query.invDir.y);
+            const __m128 iz = _mm_set1_ps(query.invDir.z);
+
+            const __m128 tx0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minX), ox), ix);
+            const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxX), ox), ix);
+            const __m128 ty0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minY), oy), iy);
+            const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxY), oy), iy);
+            const __m128 tz0 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.minZ), oz), iz);
+            const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(_mm_load_ps(node.maxZ), oz), iz);
+
+            const __m128 tmin = _mm_max_ps(
+                _mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)),
+                _mm_max_ps(_mm_min_ps(tz0, tz1), _mm_set1_ps(clip.min))
+            );
+            const __m128 tmax = _mm_min_ps(
+                _mm_mul_ps(_mm_min_ps(_mm_max_ps(tx0, tx1), _mm_min_ps(_mm_max_ps(ty0, ty1), _mm_max_ps(tz0, tz1))), _mm_set1_ps(SlabRobustFactor)),
+                _mm_set1_ps(clip.max)
+            );
+
+            _mm_storeu_ps(tNear, tmin);
+            u32 mask = static_cast<u32>(_mm_movemask_ps(_mm_cmple_ps(tmin, tmax)));
+#else
+            u32 mask = 0;
+            for (u32 i = 0; i < WideBVHNode::Width; ++i) {
+                f32 tx0 = (node.minX[i] - query.origin.x) * query.invDir.x;
+                f32 tx1 = (node.maxX[i] - query.origin.x) * query.invDir.x;
+                f32 ty0 = (node.minY[i] - query.origin.y) * query.invDir.y;
+                f32 ty1 = (node.maxY[i] - query.origin.y) * query.invDir.y;
+                f32 tz0 = (node.minZ[i] - query.origin.z) * query.invDir.z;
+                f32 tz1 = (node.maxZ[i] - query.origin.z) * query.invDir.z;
+
+                f32 tmin = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), clip.min));
+                f32 tmax = std::min(std::min(std::max(tx0, tx1), std::min(std::max(ty0, ty1), std::max(tz0, tz1))) * SlabRobustFactor, clip.max);
+
+                tNear[i] = tmin;
+                mask |= static_cast<u32>(tmin <= tmax) << i;
+            }
+#endif
+            return mask & ((1u << node.childCount) - 1u);
+        }
+
+        auto DecodePlane(f32 origin, f32 scale, u8 q) -> f32
+        {
+            return origin + static_cast<f32>(q) * scale;
+        }
+
+#if KYBER_SIMD_SSE
+        auto DecodePlanes(__m128 origin, __m128 scale, const u8* q) -> __m128
+        {
+            i32 packed;
+            std::memcpy(&packed, q, sizeof(packed));
+
+            const __m128i zero = _mm_setzero_si128();
+            __m128i lanes = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(packed), zero), zero);
+
+            return _mm_add_ps(origin, _mm_mul_ps(_mm_cvtepi32_ps(lanes), scale));
+        }
+#endif
+
+        auto IntersectChildren(const CompressedWideBVHNode& node, const RayQuery& query, const Interval& clip, f32* tNear) -> u32
+        {
+            // Exponents are kept within the normal range, so the scale can be assembled directly from its bits
+            f32 scale[3];
+            for (u32 axis = 0; axis < 3; ++axis) {
+                scale[axis] = std::bit_cast<f32>(static_cast<u32>(node.exponents[axis] + 127) << 23);
+            }
+
+#if KYBER_SIMD_SSE
+            const __m128 nx = _mm_set1_ps(node.origin[0]);
+            const __m128 ny = _mm_set1_ps(node.origin[1]);
+            const __m128 nz = _mm_set1_ps(node.origin[2]);
+
+            const __m128 sx = _mm_set1_ps(scale[0]);
+            const __m128 sy = _mm_set1_ps(scale[1]);
+            const __m128 sz = _mm_set1_ps(scale[2]);
+
+            const __m128 ox = _mm_set1_ps(query.origin.x);
+            const __m128 oy = _mm_set1_ps(query.origin.y);
+            const __m128 oz = _mm_set1_ps(query.origin.z);
+
+            const __m128 ix = _mm_set1_ps(query.invDir.x);
+            const __m128 iy = _mm_set1_ps(query.invDir.y);
+            const __m128 iz = _mm_set1_ps(query.invDir.z);
+
+            const __m128 tx0 = _mm_mul_ps(_mm_sub_ps(DecodePlanes(nx, sx, node.qMinX), ox), ix);
+            const __m128 tx1 = _mm_mul_ps(_mm_sub_ps(DecodePlanes(nx, sx, node.qMaxX), ox), ix);
+            const __m128 ty0 = _mm_mul_ps(_mm_sub_ps(DecodePlanes(ny, sy, node.qMinY), oy), iy);
+            const __m128 ty1 = _mm_mul_ps(_mm_sub_ps(DecodePlanes(ny, sy, node.qMaxY), oy), iy);
+            const __m128 tz0 = _mm_mul_ps(_mm_sub_ps(DecodePlanes(nz, sz, node.qMinZ), oz), iz);
+            const __m128 tz1 = _mm_mul_ps(_mm_sub_ps(DecodePlanes(nz, sz, node.qMaxZ), oz), iz);
+
+            const __m128 tmin = _mm_max_ps(
+                _mm_max_ps(_mm_min_ps(tx0, tx1), _mm_min_ps(ty0, ty1)),
+                _mm_max_ps(_mm_min_ps(tz0, tz1), _mm_set1_ps(clip.min))
+            );
+            const __m128 tmax = _mm_min_ps(
+                _mm_mul_ps(_mm_min_ps(_mm_max_ps(tx0, tx1), _mm_min_ps(_mm_max_ps(ty0, ty1), _mm_max_ps(tz0, tz1))), _mm_set1_ps(SlabRobustFactor)),
+                _mm_set1_ps(clip.max)
+            );
+
+            _mm_storeu_ps(tNear, tmin);
+            u32 mask = static_cast<u32>(_mm_movemask_ps(_mm_cmple_ps(tmin, tmax)));
+#else
+            u32 mask = 0;
+            for (u32 i = 0; i < CompressedWideBVHNode::Width; ++i) {
+                f32 tx0 = (DecodePlane(node.origin[0], scale[0], node.qMinX[i]) - query.origin.x) * query.invDir.x;
+                f32 tx1 = (DecodePlane(node.origin[0], scale[0], node.qMaxX[i]) - query.origin.x) * query.invDir.x;
+                f32 ty0 = (DecodePlane(node.origin[1], scale[1], node.qMinY[i]) - query.origin.y) * query.invDir.y;
+                f32 ty1 = (DecodePlane(node.origin[1], scale[1], node.qMaxY[i]) - query.origin.y) * query.invDir.y;
+                f32 tz0 = (DecodePlane(node.origin[2], scale[2], node.qMinZ[i]) - query.origin.z) * query.invDir.z;
+                f32 tz1 = (DecodePlane(node.origin[2], scale[2], node.qMaxZ[i]) - query.origin.z) * query.invDir.z;
+
+                f32 tmin = std::max(std::max(std::min(tx0, tx1), std::min(ty0, ty1)), std::max(std::min(tz0, tz1), clip.min));
+                f32 tmax = std::min(std::min(std::max(tx0, tx1), std::min(std::max(ty0, ty1), std::max(tz0, tz1))) * SlabRobustFactor, clip.max);
+
+                tNear[i] = tmin;
+                mask |= static_cast<u32>(tmin <= tmax) << i;
+            }
+#endif
+            return mask & ((1u << node.childCount) - 1u);
+        }
+
+        // Quantization is conservative: decoded child boxes always enclose the original ones
+        auto CompressNode(const WideBVHNode& node) -> CompressedWideBVHNode
+        {
+            CompressedWideBVHNode compressed {};
+            compressed.childCount = static_cast<u8>(node.childCount);
+
+            const f32* mins[3] = { node.minX, node.minY, node.minZ };
+            const f32* maxs[3] = { node.maxX, node.maxY, node.maxZ };
+            u8* qMins[3] = { compressed.qMinX, compressed.qMinY, compressed.qMinZ };
+            u8* qMaxs[3] = { compressed.qMaxX, compressed.qMaxY, compressed.qMaxZ };
+
+            for (u32 axis = 0; axis < 3; ++axis) {
+                f32 lo = std::numeric_limits<f32>::infinity();
+                f32 hi = -std::numeric_limits<f32>::infinity();
+                for (u32 i = 0; i < node.childCount; ++i) {
+                    lo = std::min(lo, mins[axis][i]);
+                    hi = std::max(hi, maxs[axis][i]);
+                }
+
+                i32 exponent = -126;
+                f32 extent = hi - lo;
+                if (extent > 0.0f) {
+                    std::frexp(extent / 255.0f, &exponent);
+                }
+                while (DecodePlane(lo, std::ldexp(1.0f, exponent), 255) < hi) {
+                    ++exponent;
+                }
+                exponent = std::clamp(exponent, -126, 127);
+
+                f32 scale = std::ldexp(1.0f, exponent);
+                compressed.origin[axis] = lo;
+                compressed.exponents[axis] = static_cast<i8>(exponent);
+
+                for (u32 i = 0; i < node.childCount; ++i) {
+                    i32 qlo = std::clamp(static_cast<i32>(std::floor((mins[axis][i] - lo) / scale)), 0, 255);
+                    i32 qhi = std::clamp(static_cast<i32>(std::ceil((maxs[axis][i] - lo) / scale)), 0, 255);
+
+                    while (qlo > 0 && DecodePlane(lo, scale, static_cast<u8>(qlo)) > mins[axis][i]) --qlo;
+                    while (qhi < 255 && DecodePlane(lo, scale, static_cast<u8>(qhi)) < maxs[axis][i]) ++qhi;
+
+                    qMins[axis][i] = static_cast<u8>(qlo);
+                    qMaxs[axis][i] = static_cast<u8>(qhi);
+                }
+            }
+
+            for (u32 i = 0; i < CompressedWideBVHNode::Width; ++i) {
+                compressed.children[i] = node.children[i];
+                compressed.counts[i] = node.counts[i];
+            }
+
+            return compressed;
+        }
+
+    }
+
+    WideBVH::WideBVH(
+        const std::vector<std::shared_ptr<Hittable>>& primitives,
+        const Scene* scene,
+        std::vector<WideBVHNode>&& nodes,
+        std::vector<CompressedWideBVHNode>&& compressedNodes,
+        const AABB& bounds,
+        const Stats& stats
+    )
+        : m_Hittables(primitives)
+        , m_Nodes(std::move(nodes))
+        , m_CompressedNodes(std::move(compressedNodes))
+        , m_Scene(scene)
+        , m_BBox(bounds)
+        , m_Stats(stats)
+    {
+        if (!m_Scene) {
+            m_Spheres = SphereSoA::Gather(m_Hittables);
+        }
+    }
+
+    auto WideBVH::Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit>
+    {
+        if (!m_CompressedNodes.empty()) {
+            return Traverse(m_CompressedNodes, ray, clip);
+        }
+
+        return Traverse(m_Nodes, ray, clip);
+    }
+
+    template <typename TNode>
+    auto WideBVH::Traverse(const std::vector<TNode>& nodes, const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit>
+    {
+        if (nodes.empty()) return std::nullopt;
+
+        std::optional<PrimitiveHit> closest;
+
+        const RayQuery query(ray);
+
+        StackEntry stack[TraversalStackSize];
+        u32 stackSize = 0;
+        stack[stackSize++] = { 0, clip.min };
+
+        const SphereSoA& spheres = GetSpheres();
+        const bool packedSpheres = !spheres.Empty();
+        u32 closestSphere = 0;
+
+        while (stackSize > 0) {
+            const StackEntry entry = stack[--stackSize];
+            if (entry.tNear > clip.max) continue;
+
+            const TNode& node = nodes[entry.node];
+
+            alignas(16) f32 tNear[WideBVHNode::Width];
+            u32 mask = IntersectChildren(node, query, clip, tNear);
+            if (mask == 0) continue;
+
+            ChildHit hits[WideBVHNode::Width];
+            u32 hitCount = 0;
+            while (mask) {
+                u32 slot = static_cast<u32>(std::countr_zero(mask));
+                mask &= mask - 1;
+
+                // Insertion sort, nearest child first
+                u32 i = hitCount++;
+                while (i > 0 && hits[i - 1].tNear > tNear[slot]) {
+                    hits[i] = hits[i - 1];
+                    --i;
+                }
+                hits[i] = { tNear[slot], slot };
+            }
+
+            // Leaves are intersected front to back right away so the clip shrinks before any subtree is pushed
+            for (u32 i = 0; i < hitCount; ++i) {
+                u32 slot = hits[i].slot;
+                if (node.counts[slot] == 0 || hits[i].tNear > clip.max) continue;
+
+                u32 first = node.children[slot];
+                if (packedSpheres) {
+                    if (auto t = spheres.Intersect(ray, first, node.counts[slot], clip, closestSphere)) {
+                        closest = PrimitiveHit { .t = *t, .primitive = closestSphere };
+                        clip.max = *t;
+                    }
+                    continue;
+                }
+
+                for (u32 p = first; p < first + node.counts[slot]; ++p) {
+                    if (auto hit = m_Hittables[p]->Intersect(ray, clip)) {
+                        closest = PrimitiveHit { .t = hit->t, .primitive = p, .subPrimitive = hit->primitive };
+                        clip.max = hit->t;
+                    }
+                }
+            }
+
+            // Interior children are pushed far to near so the nearest is popped first
+            for (u32 i = hitCount; i > 0; --i) {
+                u32 slot = hits[i - 1].slot;
+                if (node.counts[slot] != 0 || hits[i - 1].tNear > clip.max) continue;
+
+                stack[stackSize++] = { node.children[slot], hits[i - 1].tNear };
+            }
+        }
+
+        return closest;
+    }
+
+    auto WideBVH::Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction
+    {
+        const SphereSoA& spheres = GetSpheres();
+        if (!spheres.Empty()) return spheres.Interact(ray, hit);
+
+        return m_Hittables[hit.primitive]->Interact(ray, PrimitiveHit { .t = hit.t, .primitive = hit.subPrimitive });
+    }
+
+    auto WideBVH::Occluded(const Ray& ray, Interval clip) const -> bool
+    {
+        if (!m_CompressedNodes.empty()) {
+            return TraverseAny(m_CompressedNodes, ray, clip);
+        }
+
+        return TraverseAny(m_Nodes, ray, clip);
+    }
+
+    template <typename TNode>
+    auto WideBVH::TraverseAny(const std::vector<TNode>& nodes, const Ray& ray, const Interval& clip) const -> bool
+    {
+        if (nodes.empty()) return false;
+
+        const RayQuery query(ray);
+
+        u32 stack[TraversalStackSize];
+        u32 stackSize = 0;
+        stack[stackSize++] = 0;
+
+        const SphereSoA& spheres = GetSpheres();
+        const bool packedSpheres = !spheres.Empty();
+
+        // Any hit ends the query, so children are visited in slot order without sorting
+        while (stackSize > 0) {
+            const TNode& node = nodes[stack[--stackSize]];
+
+            alignas(16) f32 tNear[WideBVHNode::Width];
+            u32 mask = IntersectChildren(node, query, clip, tNear);
+
+            while (mask) {
+                u32 slot = static_cast<u32>(std::countr_zero(mask));
+                mask &= mask - 1;
+
+                if (node.counts[slot] == 0) {
+                    stack[stackSize++] = node.children[slot];
+                    continue;
+                }
+
+                u32 first = node.children[slot];
+                if (packedSpheres) {
+                    if (spheres.Occluded(ray, first, node.counts[slot], clip)) return true;
+                } else {
+                    for (u32 p = first; p < first + node.counts[slot]; ++p) {
+                        if (m_Hittables[p]->Occluded(ray, clip)) return true;
+                    }
+                }
+            }
+        }
+
+        return false;
+    }
+
+    auto WideBVH::Create(const BVH& bvh, WideBVHNodeFormat format) -> std::unique_ptr<WideBVH>
+    {
+        const auto& binary = bvh.GetNodes();
+        if (binary.empty()) return nullptr;
+
+        std::vector<WideBVHNode> nodes;
+        nodes.reserve(binary.size() / 2 + 1);
+
+        WideBVHCollapser collapser(binary, nodes);
+
+        std::array<u32, WideBVHNode::Width> rootSlots;
+        u32 rootCount = 0;
+        if (binary[0].nPrimitives > 0) {
+            rootSlots[rootCount++] = 0;
+        } else {
+            rootCount = collapser.GatherChildren(0, rootSlots);
+        }
+
+        collapser.Collapse(std::span<const u32>(rootSlots.data(), rootCount), 0);
+
+        std::vector<CompressedWideBVHNode> compressedNodes;
+        if (format == WideBVHNodeFormat::Compressed) {
+            compressedNodes.resize(nodes.size());
+            std::transform(std::execution::par, nodes.begin(), nodes.end(), compressedNodes.begin(), CompressNode);
+            nodes.clear();
+            nodes.shrink_to_fit();
+        }
+
+        usize nodeMemory = (format == WideBVHNodeFormat::Compressed)
+            ? compressedNodes.size() * sizeof(CompressedWideBVHNode)
+            : nodes.size() * sizeof(WideBVHNode);
+
+        u32 wideNodes = static_cast<u32>(std::max(nodes.size(), compressedNodes.size()));
+
+        Stats stats {
+            .WideNodes = wideNodes,
+            .TreeDepth = collapser.GetMaxDepth(),
+            .AverageChildren = static_cast<f32>(collapser.GetTotalChildren()) / static_cast<f32>(wideNodes),
+            .Format = format,
+            .NodeMemory = nodeMemory
+        };
+
+        KINFO("Wide BVH Collapse Metrics");
+        KINFO(" - Width: {}", WideBVHNode::Width);
+        KINFO(" - Node Format: {}", format == WideBVHNodeFormat::Compressed ? "Compressed" : "Full");
+        KINFO(" - Wide Nodes: {}", stats.WideNodes);
+        KINFO(" - Max Tree Depth: {}", stats.TreeDepth);
+        KINFO(" - Average Children: {:.2f}", stats.AverageChildren);
+        KINFO(" - Node Memory: {:.2f} KB", static_cast<f32>(stats.NodeMemory) / 1024.0f);
+
+        return std::make_unique<WideBVH>(bvh.GetPrimitives(), bvh.GetScene(), std::move(nodes), std::move(compressedNodes), binary[0].bounds, stats);
+    }
+
+}
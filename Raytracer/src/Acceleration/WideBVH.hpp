@@ -0,0 +1,109 @@
+#pragma once
+
+#include "BVH.hpp"
+
+namespace Kyber {
+
+    struct alignas(64) WideBVHNode
+    {
+        static constexpr u32 Width = 4;
+        static constexpr u32 EmptySlot = std::numeric_limits<u32>::max();
+
+        // Child bounds in SoA form so a single ray is tested against all children at once
+        f32 minX[Width];
+        f32 minY[Width];
+        f32 minZ[Width];
+        f32 maxX[Width];
+        f32 maxY[Width];
+        f32 maxZ[Width];
+
+        // Interior child: node index with count 0. Leaf child: first primitive with count > 0
+        u32 children[Width];
+        u16 counts[Width];
+        u32 childCount;
+    };
+
+    // Child bounds quantized to 8 bits per plane relative to the parent box (CWBVH style), one cache line per node
+    struct alignas(64) CompressedWideBVHNode
+    {
+        static constexpr u32 Width = WideBVHNode::Width;
+
+        f32 origin[3];
+        i8 exponents[3];
+        u8 childCount;
+
+        u8 qMinX[Width];
+        u8 qMinY[Width];
+        u8 qMinZ[Width];
+        u8 qMaxX[Width];
+        u8 qMaxY[Width];
+        u8 qMaxZ[Width];
+
+        u32 children[Width];
+        u16 counts[Width];
+    };
+
+    static_assert(sizeof(CompressedWideBVHNode) == 64);
+
+    enum class WideBVHNodeFormat : u8
+    {
+        Full,
+        Compressed
+    };
+
+    class WideBVH final : public Hittable
+    {
+    public:
+        struct Stats
+        {
+            u32 WideNodes { 0 };
+            u32 TreeDepth { 0 };
+            f32 AverageChildren { 0.0f };
+            WideBVHNodeFormat Format { WideBVHNodeFormat::Full };
+            usize NodeMemory { 0 };
+        };
+
+    public:
+        static auto Create(const BVH& bvh, WideBVHNodeFormat format = WideBVHNodeFormat::Full) -> std::unique_ptr<WideBVH>;
+
+        WideBVH() = default;
+        WideBVH(
+            const std::vector<std::shared_ptr<Hittable>>& primitives,
+            const Scene* scene,
+            std::vector<WideBVHNode>&& nodes,
+            std::vector<CompressedWideBVHNode>&& compressedNodes,
+            const AABB& bounds,
+            const Stats& stats
+        );
+
+        virtual ~WideBVH() = default;
+
+        virtual auto GetBBox() const -> AABB override { return m_BBox; }
+        virtual auto Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit> override;
+        virtual auto Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction override;
+        virtual auto Occluded(const Ray& ray, Interval clip) const -> bool override;
+
+        auto GetStats() const -> Stats { return m_Stats; }
+        auto GetSpheres() const -> const SphereSoA& { return m_Scene ? m_Scene->GetSpheres() : m_Spheres; }
+
+    private:
+        template <typename TNode>
+        auto Traverse(const std::vector<TNode>& nodes, const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit>;
+
+        template <typename TNode>
+        auto TraverseAny(const std::vector<TNode>& nodes, const Ray& ray, const Interval& clip) const -> bool;
+
+    private:
+        std::vector<std::shared_ptr<Hittable>> m_Hittables;
+        std::vector<WideBVHNode> m_Nodes;
+        std::vector<CompressedWideBVHNode> m_CompressedNodes;
+
+        // Shares the source BVH's leaf order, so scene-backed trees index the scene's arrays as well
+        const Scene* m_Scene { nullptr };
+        SphereSoA m_Spheres;
+        AABB m_BBox;
+
+        Stats m_Stats;
+    };
+
+}
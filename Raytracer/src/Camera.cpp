@@ -1,6 +1,6 @@
 #include "Camera.hpp"
 
-#include "Core/RNG.hpp"
+#include "Core/Sampler.hpp"
 
 namespace Kyber {
 
@@ -53,23 +53,20 @@ namespace Kyber {
         m_DefocusV = v * defocusRadius;
     }
 
-    auto Camera::GetRay(u32 x, u32 y, const glm::vec2& offset) const -> Ray
+    auto Camera::GetRay(u32 x, u32 y, const glm::vec2& offset, const glm::vec2& lens) const -> Ray
+    {
+        return GetRayFromDisk(x, y, offset, SquareToUnitDisk(lens));
+    }
+
+    auto Camera::GetRayFromDisk(u32 x, u32 y, const glm::vec2& offset, const glm::vec2& disk) const -> Ray
     {
         glm::vec3 pixel = m_Pixel00
             + (static_cast<f32>(x) + offset.x) * m_PixelDu
             + (static_cast<f32>(y) + offset.y) * m_PixelDv;
 
-        static auto defocusSample = [](const glm::vec3& center, const glm::vec3& u, const glm::vec3& v) -> glm::vec3
-        {
-            glm::vec2 p = RNG::InUnitDisk();
-            return center + p.x * u + p.y * v;
-        };
-
-        glm::vec3 origin;
-        if (m_DefocusAngle <= 0.0f) {
-            origin = m_LookFrom;
-        } else {
-            origin = defocusSample(m_LookFrom, m_DefocusU, m_DefocusV);
+        glm::vec3 origin = m_LookFrom;
+        if (m_DefocusAngle > 0.0f) {
+            origin += disk.x * m_DefocusU + disk.y * m_DefocusV;
         }
 
         return Ray(origin, pixel - origin);
@@ -21,7 +21,11 @@ namespace Kyber {
         ~Camera() = default;
 
         auto Resize(u32 width, u32 height) -> void;
-        auto GetRay(u32 x, u32 y, const glm::vec2& offset = glm::vec2(0.0f)) const -> Ray;
+        // Offset jitters within the pixel; lens is a [0, 1)^2 sample mapped onto the defocus disk
+        auto GetRay(u32 x, u32 y, const glm::vec2& offset = glm::vec2(0.0f), const glm::vec2& lens = glm::vec2(0.5f)) const -> Ray;
+
+        // Same, for a lens sample already mapped onto the unit disk (batched ray generation)
+        auto GetRayFromDisk(u32 x, u32 y, const glm::vec2& offset, const glm::vec2& disk) const -> Ray;
 
     private:
         f32 m_VFOV;
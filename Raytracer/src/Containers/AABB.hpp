@@ -4,6 +4,7 @@
 
 #include "Interval.hpp"
 #include "Ray.hpp"
+#include "RayQuery.hpp"
 
 namespace Kyber {
 
@@ -41,7 +42,35 @@ namespace Kyber {
             return x;
         }
 
+        auto Min() const -> glm::vec3 { return glm::vec3(x.min, y.min, z.min); }
+        auto Max() const -> glm::vec3 { return glm::vec3(x.max, y.max, z.max); }
+
+        auto SurfaceArea() const -> f32
+        {
+            f32 dx = x.Size();
+            f32 dy = y.Size();
+            f32 dz = z.Size();
+
+            if (dx < 0.0f || dy < 0.0f || dz < 0.0f) return 0.0f;
+            return 2.0f * (dx * dy + dy * dz + dz * dx);
+        }
+
         auto Hit(const Ray& ray, Interval clip) const -> bool;
+
+        // Branchless slab test against precomputed ray data
+        auto Hit(const RayQuery& query, const Interval& clip) const -> bool
+        {
+            glm::vec3 t0 = (Min() - query.origin) * query.invDir;
+            glm::vec3 t1 = (Max() - query.origin) * query.invDir;
+
+            glm::vec3 tNear = glm::min(t0, t1);
+            glm::vec3 tFar = glm::max(t0, t1);
+
+            f32 tMin = std::max(std::max(tNear.x, tNear.y), std::max(tNear.z, clip.min));
+            f32 tMax = std::min(std::min(tFar.x, tFar.y) * SlabRobustFactor, std::min(tFar.z * SlabRobustFactor, clip.max));
+
+            return tMin <= tMax;
+        }
     };
 
 }
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Ray.hpp"
+#include "RayQuery.hpp"
+
+namespace Kyber {
+
+    // N coherent rays in SoA form, processed four lanes at a time
+    template <usize N>
+    struct RayPacket
+    {
+        static_assert(N % 4 == 0 && N <= 32, "Packet size must be a multiple of 4 and at most 32");
+
+        static constexpr u32 Size = static_cast<u32>(N);
+        static constexpr u32 Groups = static_cast<u32>(N / 4);
+
+        alignas(16) f32 originX[N];
+        alignas(16) f32 originY[N];
+        alignas(16) f32 originZ[N];
+
+        alignas(16) f32 directionX[N];
+        alignas(16) f32 directionY[N];
+        alignas(16) f32 directionZ[N];
+
+        alignas(16) f32 invDirX[N];
+        alignas(16) f32 invDirY[N];
+        alignas(16) f32 invDirZ[N];
+
+        // Per-lane closest hit so far; inactive lanes are kept at -inf so no box or primitive accepts them
+        alignas(16) f32 tMax[N];
+        alignas(16) u32 primitive[N];
+
+        u32 activeMask { 0 };
+
+        RayPacket()
+        {
+            for (u32 i = 0; i < N; ++i) {
+                originX[i] = originY[i] = originZ[i] = 0.0f;
+                directionX[i] = directionY[i] = directionZ[i] = 1.0f;
+                invDirX[i] = invDirY[i] = invDirZ[i] = 1.0f;
+                tMax[i] = -std::numeric_limits<f32>::infinity();
+                primitive[i] = 0;
+            }
+        }
+
+        auto Set(u32 lane, const Ray& ray) -> void
+        {
+            originX[lane] = ray.origin.x;
+            originY[lane] = ray.origin.y;
+            originZ[lane] = ray.origin.z;
+
+            directionX[lane] = ray.direction.x;
+            directionY[lane] = ray.direction.y;
+            directionZ[lane] = ray.direction.z;
+
+            invDirX[lane] = RayQuery::SafeInverse(ray.direction.x);
+            invDirY[lane] = RayQuery::SafeInverse(ray.direction.y);
+            invDirZ[lane] = RayQuery::SafeInverse(ray.direction.z);
+
+            tMax[lane] = std::numeric_limits<f32>::infinity();
+            activeMask |= 1u << lane;
+        }
+
+        auto GetRay(u32 lane) const -> Ray
+        {
+            return Ray(
+                glm::vec3(originX[lane], originY[lane], originZ[lane]),
+                glm::vec3(directionX[lane], directionY[lane], directionZ[lane])
+            );
+        }
+    };
+
+}
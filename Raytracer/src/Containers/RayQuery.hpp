@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Ray.hpp"
+
+namespace Kyber {
+
+    // Bound on the relative rounding error of n chained float operations
+    constexpr auto Gamma(i32 n) -> f32
+    {
+        constexpr f32 e = std::numeric_limits<f32>::epsilon() * 0.5f;
+        return (static_cast<f32>(n) * e) / (1.0f - static_cast<f32>(n) * e);
+    }
+
+    // Far slab distances are widened by this factor so rounding never opens gaps between boxes (Ize 2013)
+    inline constexpr f32 SlabRobustFactor = 1.0f + 2.0f * Gamma(3);
+
+    // Per-ray data shared by every box test of a traversal
+    struct RayQuery
+    {
+        glm::vec3 origin;
+        glm::vec3 invDir;
+        u32 dirIsNeg[3];
+
+        explicit RayQuery(const Ray& ray)
+            : origin(ray.origin)
+            , invDir(SafeInverse(ray.direction.x), SafeInverse(ray.direction.y), SafeInverse(ray.direction.z))
+        {
+            dirIsNeg[0] = invDir.x < 0.0f;
+            dirIsNeg[1] = invDir.y < 0.0f;
+            dirIsNeg[2] = invDir.z < 0.0f;
+        }
+
+        // Zero components get a huge but finite reciprocal, so slab distances never become inf - inf = NaN
+        static auto SafeInverse(f32 d) -> f32
+        {
+            constexpr f32 MinComponent = 1e-20f;
+            return 1.0f / (std::abs(d) > MinComponent ? d : std::copysign(MinComponent, d));
+        }
+    };
+
+}
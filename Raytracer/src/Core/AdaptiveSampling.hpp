@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "TileScheduler.hpp"
+
+namespace Kyber {
+
+    struct AdaptiveSamplingOptions
+    {
+        bool Enabled { false };
+
+        // Passes every tile takes before its error estimate is trusted; kept even so both halves match
+        u32 MinSamples { 32 };
+
+        // Tiles retire once their mean relative error drops below this
+        f32 Threshold { 0.02f };
+
+        // Noisy tiles may keep going up to this multiple of the sample count
+        u32 MaxSampleScale { 4 };
+    };
+
+    // The accumulator holds the sum of every sample, the half accumulator only the odd-numbered ones.
+    // Their means are two estimates of the pixel, and how far they sit apart tracks the error left in
+    // it. Unlike a per-sample variance this holds up for low-discrepancy samples, which aren't
+    // independent. Divided by the square root of the brightness, as noise is judged relative to it.
+    inline auto PixelError(const glm::vec4& full, const glm::vec4& half) -> f32
+    {
+        if (full.a <= 0.0f || half.a <= 0.0f) return std::numeric_limits<f32>::infinity();
+
+        glm::vec3 mean = glm::vec3(full) / full.a;
+        glm::vec3 halfMean = glm::vec3(half) / half.a;
+
+        glm::vec3 difference = glm::abs(mean - halfMean);
+        return (difference.x + difference.y + difference.z) / std::sqrt(std::max(mean.x + mean.y + mean.z, 1e-4f));
+    }
+
+    inline auto TileError(const Tile& tile, u32 stride, std::span<const glm::vec4> accumulator, std::span<const glm::vec4> halfAccumulator) -> f32
+    {
+        f32 error = 0.0f;
+
+        for (u32 y = tile.y; y < tile.y + tile.h; ++y) {
+            for (u32 x = tile.x; x < tile.x + tile.w; ++x) {
+                usize index = x + static_cast<usize>(y) * stride;
+                error += PixelError(accumulator[index], halfAccumulator[index]);
+            }
+        }
+
+        return error / static_cast<f32>(tile.w * tile.h);
+    }
+
+    // False colour for the viewport heatmap, on a log scale around the threshold: blue has converged,
+    // green is within 4x of it and red is 16x or more
+    inline auto ErrorHeatmap(f32 error, f32 threshold) -> glm::vec3
+    {
+        if (!std::isfinite(error)) return glm::vec3(0.0f);
+
+        f32 t = std::clamp(std::log2(std::max(error / threshold, 1e-6f)) / 4.0f, 0.0f, 1.0f);
+        if (t < 0.5f) return glm::mix(glm::vec3(0.1f, 0.2f, 0.9f), glm::vec3(0.1f, 0.8f, 0.2f), 2.0f * t);
+        return glm::mix(glm::vec3(0.1f, 0.8f, 0.2f), glm::vec3(0.9f, 0.1f, 0.1f), 2.0f * t - 1.0f);
+    }
+
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Kyber {
+
+    // Spreads the low 10 bits of v so there are two zero bits between each
+    inline auto ExpandBits(u32 v) -> u32
+    {
+        v = (v * 0x00010001u) & 0xFF0000FFu;
+        v = (v * 0x00000101u) & 0x0F00F00Fu;
+        v = (v * 0x00000011u) & 0xC30C30C3u;
+        v = (v * 0x00000005u) & 0x49249249u;
+        return v;
+    }
+
+    // 30-bit Morton code for a point in [0, 1]^3
+    inline auto Morton3D(const glm::vec3& p) -> u32
+    {
+        u32 x = static_cast<u32>(std::clamp(p.x * 1024.0f, 0.0f, 1023.0f));
+        u32 y = static_cast<u32>(std::clamp(p.y * 1024.0f, 0.0f, 1023.0f));
+        u32 z = static_cast<u32>(std::clamp(p.z * 1024.0f, 0.0f, 1023.0f));
+        return (ExpandBits(x) << 2) | (ExpandBits(y) << 1) | ExpandBits(z);
+    }
+
+    // Spreads the low 16 bits of v so there is one zero bit between each
+    inline auto ExpandBits2D(u32 v) -> u32
+    {
+        v &= 0x0000FFFFu;
+        v = (v | (v << 8)) & 0x00FF00FFu;
+        v = (v | (v << 4)) & 0x0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x33333333u;
+        v = (v | (v << 1)) & 0x55555555u;
+        return v;
+    }
+
+    // Inverse of ExpandBits2D: gathers every other bit, starting at bit 0
+    inline auto CompactBits2D(u32 v) -> u32
+    {
+        v &= 0x55555555u;
+        v = (v | (v >> 1)) & 0x33333333u;
+        v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+        v = (v | (v >> 4)) & 0x00FF00FFu;
+        v = (v | (v >> 8)) & 0x0000FFFFu;
+        return v;
+    }
+
+    inline auto Morton2D(u32 x, u32 y) -> u32
+    {
+        return ExpandBits2D(x) | (ExpandBits2D(y) << 1);
+    }
+
+    // Distance of (x, y) along the Hilbert curve filling a side x side grid, side a power of two. Unlike
+    // Morton order, consecutive cells are always neighbours.
+    inline auto HilbertIndex(u32 side, u32 x, u32 y) -> u32
+    {
+        u32 index = 0;
+
+        for (u32 s = side / 2; s > 0; s /= 2) {
+            u32 rx = (x & s) > 0 ? 1 : 0;
+            u32 ry = (y & s) > 0 ? 1 : 0;
+            index += s * s * ((3 * rx) ^ ry);
+
+            // Rotate the quadrant so the sub-curve enters and leaves where its neighbours expect
+            if (ry == 0) {
+                if (rx == 1) {
+                    x = side - 1 - x;
+                    y = side - 1 - y;
+                }
+                std::swap(x, y);
+            }
+        }
+
+        return index;
+    }
+
+}
@@ -1,6 +1,7 @@
 #include "PostProcess.hpp"
 
 #include <glad/gl.h>
+#include <Kyber/Core/JobSystem.hpp>
 
 #define STB_IMAGE_WRITE_IMPLEMENTATION
 #include <stb_image_write.h>
@@ -101,25 +102,27 @@ namespace Kyber {
 
     auto PostProcess::UploadTiles(const std::span<const glm::vec4>& framebuffer, const std::vector<Tile>& tiles) const -> void
     {
-        std::for_each(std::execution::par, tiles.begin(), tiles.end(), [&](const Tile& tile) {
-            usize rowStride = m_Width * sizeof(glm::vec4);
-            usize tileRowBytes = tile.w * sizeof(glm::vec4);
-
-            if (tile.w == m_Width) {
-                usize startPixel = tile.x + tile.y * m_Width;
-                std::memcpy(
-                    static_cast<std::byte*>(m_MappedPtr) + startPixel * sizeof(glm::vec4),
-                    framebuffer.data() + startPixel,
-                    tileRowBytes * tile.h
-                );
-            } else {
-                for (u32 row = 0; row < tile.h; ++row) {
-                    usize pixelIndex = tile.x + (tile.y + row) * m_Width;
+        // On the shared job pool; while a render holds the workers the main thread copies on its own
+        JobSystem::ParallelFor(tiles.size(), 1, [&](usize begin, usize end) {
+            for (const Tile& tile : std::span(tiles).subspan(begin, end - begin)) {
+                usize tileRowBytes = tile.w * sizeof(glm::vec4);
+
+                if (tile.w == m_Width) {
+                    usize startPixel = tile.x + tile.y * m_Width;
                     std::memcpy(
-                        static_cast<std::byte*>(m_MappedPtr) + pixelIndex * sizeof(glm::vec4),
-                        framebuffer.data() + pixelIndex,
-                        tileRowBytes
+                        static_cast<std::byte*>(m_MappedPtr) + startPixel * sizeof(glm::vec4),
+                        framebuffer.data() + startPixel,
+                        tileRowBytes * tile.h
                     );
+                } else {
+                    for (u32 row = 0; row < tile.h; ++row) {
+                        usize pixelIndex = tile.x + (tile.y + row) * m_Width;
+                        std::memcpy(
+                            static_cast<std::byte*>(m_MappedPtr) + pixelIndex * sizeof(glm::vec4),
+                            framebuffer.data() + pixelIndex,
+                            tileRowBytes
+                        );
+                    }
                 }
             }
         });
@@ -138,6 +141,7 @@ namespace Kyber {
 
         glUniform1i(0, m_Width);
         glUniform1i(1, m_Height);
+        glUniform1i(2, m_Tonemapping);
 
         glDispatchCompute((m_Width + 7) / 8, (m_Height + 7) / 8, 1);
 
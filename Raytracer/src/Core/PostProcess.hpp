@@ -23,6 +23,12 @@ namespace Kyber {
             return m_OutputTexture;
         }
 
+        // Off for buffers that already hold display colours, such as the error heatmap
+        auto SetTonemapping(bool enabled) -> void
+        {
+            m_Tonemapping = enabled;
+        }
+
     private:
         u32 m_Width { 0 };
         u32 m_Height { 0 };
@@ -34,6 +40,8 @@ namespace Kyber {
         u32 m_OutputTexture { 0 };
 
         u32 m_Program { 0 };
+
+        bool m_Tonemapping { true };
     };
 
 }
@@ -8,6 +8,12 @@ namespace Kyber {
     class RNG
     {
     public:
+        // Reseeds the calling thread's generator, e.g. so scene construction repeats exactly
+        inline static auto Seed(u64 seed) -> void
+        {
+            s_State = XoshiroState(seed);
+        }
+
         inline static auto U32() -> u32
         {
             return Next();
@@ -82,10 +88,12 @@ namespace Kyber {
             u32 s[4];
 
             XoshiroState()
+                : XoshiroState((static_cast<u64>(std::random_device{}()) << 32) | std::random_device{}())
             {
-                std::random_device rd;
-                u64 seed = (static_cast<u64>(rd()) << 32) | rd(); 
+            }
 
+            XoshiroState(u64 seed)
+            {
                 auto splitmix64 = [&seed]() -> u32 {
                     u64 z = (seed += 0x9e3779b97f4a7c15);
                     z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9;
@@ -121,4 +129,60 @@ namespace Kyber {
         inline static thread_local XoshiroState s_State;
     };
 
+    // Stateless generator: the same (key, counter) always gives the same bits, whichever thread asks
+    // and in whatever order
+    class CounterRNG
+    {
+    public:
+        // Folds a multi-part key (pixel, sample, seed, ...) into a 64-bit stream key with Jarzynski and
+        // Olano's pcg4d; meant to run once per stream. A 32-bit key would repeat within a single
+        // high-resolution render, giving pixels identical streams.
+        inline static auto Key(glm::uvec4 v) -> glm::uvec2
+        {
+            v = v * 1664525u + 1013904223u;
+
+            v.x += v.y * v.w;
+            v.y += v.z * v.x;
+            v.z += v.x * v.y;
+            v.w += v.y * v.z;
+
+            v.x ^= v.x >> 16;
+            v.y ^= v.y >> 16;
+            v.z ^= v.z >> 16;
+            v.w ^= v.w >> 16;
+
+            v.x += v.y * v.w;
+            v.y += v.z * v.x;
+            v.z += v.x * v.y;
+            v.w += v.y * v.z;
+
+            return glm::uvec2(v.x ^ v.z, v.y ^ v.w);
+        }
+
+        // Word `counter` of stream `key`. The counter is hashed into one half of the key and the result
+        // into the other, so no two streams are shifted copies of each other. Fixed shifts only, so the
+        // SIMD batch kernels in Sampler.cpp produce the same bits four lanes at a time.
+        inline static auto U32(const glm::uvec2& key, u32 counter) -> u32
+        {
+            return Mix(key.x ^ Mix(key.y ^ counter));
+        }
+
+        // Two-multiply integer hash
+        inline static auto Mix(u32 x) -> u32
+        {
+            x ^= x >> 16;
+            x *= 0x21f0aaadu;
+            x ^= x >> 15;
+            x *= 0x735a2d97u;
+            x ^= x >> 15;
+            return x;
+        }
+
+        // Same mantissa trick as RNG::F32
+        inline static auto ToF32(u32 bits) -> f32
+        {
+            return std::bit_cast<f32>(0x3F800000 | (bits >> 9)) - 1.0f;
+        }
+    };
+
 }
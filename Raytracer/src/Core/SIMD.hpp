@@ -0,0 +1,8 @@
+#pragma once
+
+#if defined(__SSE2__) || defined(_M_X64) || defined(_M_AMD64)
+    #define KYBER_SIMD_SSE 1
+    #include <immintrin.h>
+#else
+    #define KYBER_SIMD_SSE 0
+#endif
@@ -0,0 +1,488 @@
+#include "Sampler.hpp"
+
+#include "Core/SIMD.hpp"
+
+namespace Kyber {
+
+    namespace {
+
+        constexpr u32 MaskSize = 64;
+        constexpr u32 MaskArea = MaskSize * MaskSize;
+
+        auto Hash(u32 x) -> u32
+        {
+            x ^= x >> 16;
+            x *= 0x7feb352du;
+            x ^= x >> 15;
+            x *= 0x846ca68bu;
+            x ^= x >> 16;
+            return x;
+        }
+
+        auto HashCombine(u32 seed, u32 value) -> u32
+        {
+            return Hash(seed ^ (value + 0x9e3779b9u + (seed << 6) + (seed >> 2)));
+        }
+
+        auto ReverseBits(u32 x) -> u32
+        {
+            x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+            x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+            x = ((x >> 4) & 0x0F0F0F0Fu) | ((x & 0x0F0F0F0Fu) << 4);
+            x = ((x >> 8) & 0x00FF00FFu) | ((x & 0x00FF00FFu) << 8);
+            return (x >> 16) | (x << 16);
+        }
+
+        // Each output bit only depends on the input bits below it, so on bit-reversed values this is
+        // an Owen scramble (Laine and Karras, as refined by Burley)
+        auto LaineKarrasPermutation(u32 x, u32 seed) -> u32
+        {
+            x += seed;
+            x ^= x * 0x6c50b47cu;
+            x ^= x * 0xb82f1e52u;
+            x ^= x * 0xc7afe638u;
+            x ^= x * 0x8d22f6e6u;
+            return x;
+        }
+
+        auto NestedUniformScramble(u32 x, u32 seed) -> u32
+        {
+            return ReverseBits(LaineKarrasPermutation(ReverseBits(x), seed));
+        }
+
+        // Second Sobol dimension (primitive polynomial x + 1); the first is the bit-reversed index
+        constexpr auto SobolDirections = [] {
+            std::array<u32, 32> directions {};
+            directions[0] = 1u << 31;
+            for (u32 i = 1; i < 32; ++i) {
+                directions[i] = directions[i - 1] ^ (directions[i - 1] >> 1);
+            }
+            return directions;
+        }();
+
+        auto Sobol2D(u32 index) -> glm::uvec2
+        {
+            glm::uvec2 result(ReverseBits(index), 0u);
+            for (u32 bit = 0; index != 0; index >>= 1, ++bit) {
+                if (index & 1u) result.y ^= SobolDirections[bit];
+            }
+            return result;
+        }
+
+        // Scrambled (0,2)-sequence point; the seed picks both the shuffle and the scramble
+        auto ScrambledSobol2D(u32 index, u32 seed) -> glm::vec2
+        {
+            glm::uvec2 bits = Sobol2D(NestedUniformScramble(index, seed));
+            bits.x = NestedUniformScramble(bits.x, HashCombine(seed, 0));
+            bits.y = NestedUniformScramble(bits.y, HashCombine(seed, 1));
+
+            // Top 24 bits, so the result stays strictly below one
+            return glm::vec2(static_cast<f32>(bits.x >> 8), static_cast<f32>(bits.y >> 8)) * 0x1p-24f;
+        }
+
+        // 64x64 blue-noise threshold mask from Ulichney's void-and-cluster method
+        auto GenerateBlueNoiseMask() -> std::vector<f32>
+        {
+            constexpr f32 Sigma = 1.5f;
+
+            // Gaussian energy of a point at every toroidal offset
+            std::vector<f32> kernel(MaskArea);
+            for (u32 y = 0; y < MaskSize; ++y) {
+                for (u32 x = 0; x < MaskSize; ++x) {
+                    f32 dx = static_cast<f32>(std::min(x, MaskSize - x));
+                    f32 dy = static_cast<f32>(std::min(y, MaskSize - y));
+                    kernel[x + y * MaskSize] = std::exp(-(dx * dx + dy * dy) / (2.0f * Sigma * Sigma));
+                }
+            }
+
+            std::vector<u8> pattern(MaskArea, 0);
+            std::vector<f32> energy(MaskArea, 0.0f);
+
+            auto toggle = [&](u32 p, bool set) {
+                u32 px = p % MaskSize;
+                u32 py = p / MaskSize;
+                f32 sign = set ? 1.0f : -1.0f;
+
+                for (u32 y = 0; y < MaskSize; ++y) {
+                    for (u32 x = 0; x < MaskSize; ++x) {
+                        energy[x + y * MaskSize] += sign * kernel[((x - px) % MaskSize) + ((y - py) % MaskSize) * MaskSize];
+                    }
+                }
+                pattern[p] = set;
+            };
+
+            auto tightestCluster = [&] {
+                u32 best = 0;
+                f32 bestEnergy = -std::numeric_limits<f32>::infinity();
+                for (u32 i = 0; i < MaskArea; ++i) {
+                    if (pattern[i] && energy[i] > bestEnergy) { best = i; bestEnergy = energy[i]; }
+                }
+                return best;
+            };
+
+            auto largestVoid = [&] {
+                u32 best = 0;
+                f32 bestEnergy = std::numeric_limits<f32>::infinity();
+                for (u32 i = 0; i < MaskArea; ++i) {
+                    if (!pattern[i] && energy[i] < bestEnergy) { best = i; bestEnergy = energy[i]; }
+                }
+                return best;
+            };
+
+            // Seed a tenth of the cells with a fixed hash so the mask is the same on every run
+            const u32 initialCount = MaskArea / 10;
+            for (u32 i = 0; i < initialCount; ++i) {
+                u32 p = Hash(i) % MaskArea;
+                while (pattern[p]) p = (p + 1) % MaskArea;
+                toggle(p, true);
+            }
+
+            // Move the tightest cluster into the largest void until that stops changing anything; the
+            // cap only guards against a swap cycle
+            for (u32 iteration = 0; iteration < MaskArea; ++iteration) {
+                u32 cluster = tightestCluster();
+                toggle(cluster, false);
+
+                u32 hole = largestVoid();
+                toggle(hole, true);
+
+                if (hole == cluster) break;
+            }
+
+            const std::vector<u8> initialPattern = pattern;
+            const std::vector<f32> initialEnergy = energy;
+
+            std::vector<u32> rank(MaskArea);
+
+            // Ranks below the initial pattern come from removing its clusters one by one
+            for (u32 r = initialCount; r-- > 0;) {
+                u32 cluster = tightestCluster();
+                toggle(cluster, false);
+                rank[cluster] = r;
+            }
+
+            // Ranks above it come from filling the largest remaining void
+            pattern = initialPattern;
+            energy = initialEnergy;
+            for (u32 r = initialCount; r < MaskArea; ++r) {
+                u32 hole = largestVoid();
+                toggle(hole, true);
+                rank[hole] = r;
+            }
+
+            std::vector<f32> mask(MaskArea);
+            for (u32 i = 0; i < MaskArea; ++i) {
+                mask[i] = (static_cast<f32>(rank[i]) + 0.5f) / static_cast<f32>(MaskArea);
+            }
+
+            return mask;
+        }
+
+        auto BlueNoise(u32 x, u32 y) -> f32
+        {
+            static const std::vector<f32> s_Mask = GenerateBlueNoiseMask();
+            return s_Mask[(x % MaskSize) + (y % MaskSize) * MaskSize];
+        }
+
+#if KYBER_SIMD_SSE
+        auto Select(__m128 mask, __m128 a, __m128 b) -> __m128
+        {
+            return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+        }
+
+        // SSE2 has no 32-bit low multiply, so it is assembled from the two 32x32->64 products
+        auto MulLo32(__m128i a, __m128i b) -> __m128i
+        {
+            __m128i even = _mm_mul_epu32(a, b);
+            __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), _mm_srli_epi64(b, 32));
+            return _mm_unpacklo_epi32(_mm_shuffle_epi32(even, _MM_SHUFFLE(0, 0, 2, 0)), _mm_shuffle_epi32(odd, _MM_SHUFFLE(0, 0, 2, 0)));
+        }
+
+        // Four lanes of CounterRNG::Mix
+        auto Mix4(__m128i x) -> __m128i
+        {
+            x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+            x = MulLo32(x, _mm_set1_epi32(static_cast<i32>(0x21f0aaadu)));
+            x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+            x = MulLo32(x, _mm_set1_epi32(static_cast<i32>(0x735a2d97u)));
+            x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+            return x;
+        }
+
+        // Four lanes of CounterRNG::U32, with the key halves in separate registers
+        auto CounterU32x4(__m128i keyX, __m128i keyY, __m128i counter) -> __m128i
+        {
+            return Mix4(_mm_xor_si128(keyX, Mix4(_mm_xor_si128(keyY, counter))));
+        }
+
+        // Four lanes of Hash and HashCombine
+        auto Hash4(__m128i x) -> __m128i
+        {
+            x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+            x = MulLo32(x, _mm_set1_epi32(static_cast<i32>(0x7feb352du)));
+            x = _mm_xor_si128(x, _mm_srli_epi32(x, 15));
+            x = MulLo32(x, _mm_set1_epi32(static_cast<i32>(0x846ca68bu)));
+            x = _mm_xor_si128(x, _mm_srli_epi32(x, 16));
+            return x;
+        }
+
+        auto HashCombine4(__m128i seed, __m128i value) -> __m128i
+        {
+            __m128i mixed = _mm_add_epi32(value, _mm_set1_epi32(static_cast<i32>(0x9e3779b9u)));
+            mixed = _mm_add_epi32(mixed, _mm_slli_epi32(seed, 6));
+            mixed = _mm_add_epi32(mixed, _mm_srli_epi32(seed, 2));
+            return Hash4(_mm_xor_si128(seed, mixed));
+        }
+
+        auto ReverseBits4(__m128i x) -> __m128i
+        {
+            auto swap = [](__m128i v, i32 mask, i32 shift) {
+                __m128i m = _mm_set1_epi32(mask);
+                return _mm_or_si128(_mm_and_si128(_mm_srli_epi32(v, shift), m), _mm_slli_epi32(_mm_and_si128(v, m), shift));
+            };
+
+            x = swap(x, 0x55555555, 1);
+            x = swap(x, 0x33333333, 2);
+            x = swap(x, 0x0F0F0F0F, 4);
+            x = swap(x, 0x00FF00FF, 8);
+            return _mm_or_si128(_mm_srli_epi32(x, 16), _mm_slli_epi32(x, 16));
+        }
+
+        auto NestedUniformScramble4(__m128i x, __m128i seed) -> __m128i
+        {
+            x = _mm_add_epi32(ReverseBits4(x), seed);
+            x = _mm_xor_si128(x, MulLo32(x, _mm_set1_epi32(static_cast<i32>(0x6c50b47cu))));
+            x = _mm_xor_si128(x, MulLo32(x, _mm_set1_epi32(static_cast<i32>(0xb82f1e52u))));
+            x = _mm_xor_si128(x, MulLo32(x, _mm_set1_epi32(static_cast<i32>(0xc7afe638u))));
+            x = _mm_xor_si128(x, MulLo32(x, _mm_set1_epi32(static_cast<i32>(0x8d22f6e6u))));
+            return ReverseBits4(x);
+        }
+
+        // Four lanes of ScrambledSobol2D; the direction loop runs until every lane's index is spent
+        auto ScrambledSobol2Dx4(__m128i index, __m128i seed, __m128& x, __m128& y) -> void
+        {
+            index = NestedUniformScramble4(index, seed);
+
+            __m128i bitsX = ReverseBits4(index);
+            __m128i bitsY = _mm_setzero_si128();
+
+            const __m128i one = _mm_set1_epi32(1);
+            for (u32 bit = 0; _mm_movemask_epi8(_mm_cmpeq_epi32(index, _mm_setzero_si128())) != 0xFFFF; ++bit) {
+                __m128i set = _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(index, one));
+                bitsY = _mm_xor_si128(bitsY, _mm_and_si128(set, _mm_set1_epi32(static_cast<i32>(SobolDirections[bit]))));
+                index = _mm_srli_epi32(index, 1);
+            }
+
+            bitsX = NestedUniformScramble4(bitsX, HashCombine4(seed, _mm_setzero_si128()));
+            bitsY = NestedUniformScramble4(bitsY, HashCombine4(seed, one));
+
+            const __m128 scale = _mm_set1_ps(0x1p-24f);
+            x = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bitsX, 8)), scale);
+            y = _mm_mul_ps(_mm_cvtepi32_ps(_mm_srli_epi32(bitsY, 8)), scale);
+        }
+
+        auto ToF32x4(__m128i bits) -> __m128
+        {
+            __m128i mantissa = _mm_or_si128(_mm_srli_epi32(bits, 9), _mm_set1_epi32(0x3F800000));
+            return _mm_sub_ps(_mm_castsi128_ps(mantissa), _mm_set1_ps(1.0f));
+        }
+
+        // sin on [-pi, pi]: fold into [-pi/2, pi/2], then the odd Taylor series to x^11. Truncation
+        // error is below 6e-8 at the ends, so float rounding dominates.
+        auto Sin4(__m128 x) -> __m128
+        {
+            const __m128 pi = _mm_set1_ps(glm::pi<f32>());
+            const __m128 halfPi = _mm_set1_ps(0.5f * glm::pi<f32>());
+
+            x = Select(_mm_cmpgt_ps(x, halfPi), _mm_sub_ps(pi, x), x);
+            x = Select(_mm_cmplt_ps(x, _mm_sub_ps(_mm_setzero_ps(), halfPi)), _mm_sub_ps(_mm_sub_ps(_mm_setzero_ps(), pi), x), x);
+
+            __m128 x2 = _mm_mul_ps(x, x);
+            __m128 p = _mm_set1_ps(-1.0f / 39916800.0f);
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 362880.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.0f / 5040.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f / 120.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(-1.0f / 6.0f));
+            p = _mm_add_ps(_mm_mul_ps(p, x2), _mm_set1_ps(1.0f));
+            return _mm_mul_ps(p, x);
+        }
+
+        auto SinCos4(__m128 x, __m128& sin, __m128& cos) -> void
+        {
+            const __m128 pi = _mm_set1_ps(glm::pi<f32>());
+
+            sin = Sin4(x);
+
+            __m128 shifted = _mm_add_ps(x, _mm_set1_ps(0.5f * glm::pi<f32>()));
+            shifted = Select(_mm_cmpgt_ps(shifted, pi), _mm_sub_ps(shifted, _mm_set1_ps(2.0f * glm::pi<f32>())), shifted);
+            cos = Sin4(shifted);
+        }
+
+        // Four vec2s in, as separate x and y lanes
+        auto LoadVec2x4(const glm::vec2* v, __m128& x, __m128& y) -> void
+        {
+            __m128 a = _mm_loadu_ps(&v[0].x);
+            __m128 b = _mm_loadu_ps(&v[2].x);
+            x = _mm_shuffle_ps(a, b, _MM_SHUFFLE(2, 0, 2, 0));
+            y = _mm_shuffle_ps(a, b, _MM_SHUFFLE(3, 1, 3, 1));
+        }
+
+        auto StoreVec2x4(glm::vec2* v, __m128 x, __m128 y) -> void
+        {
+            _mm_storeu_ps(&v[0].x, _mm_unpacklo_ps(x, y));
+            _mm_storeu_ps(&v[2].x, _mm_unpackhi_ps(x, y));
+        }
+
+        // Concentric mapping with both branches evaluated and blended; zero denominators are
+        // swapped out so the centre maps to the origin instead of NaN
+        auto Disk4(__m128 ux, __m128 uy, __m128& x, __m128& y) -> void
+        {
+            const __m128 one = _mm_set1_ps(1.0f);
+            const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7FFFFFFF));
+            const __m128 quarterPi = _mm_set1_ps(0.25f * glm::pi<f32>());
+
+            __m128 ox = _mm_sub_ps(_mm_add_ps(ux, ux), one);
+            __m128 oy = _mm_sub_ps(_mm_add_ps(uy, uy), one);
+
+            __m128 useX = _mm_cmpgt_ps(_mm_and_ps(ox, absMask), _mm_and_ps(oy, absMask));
+            __m128 safeX = Select(_mm_cmpeq_ps(ox, _mm_setzero_ps()), one, ox);
+            __m128 safeY = Select(_mm_cmpeq_ps(oy, _mm_setzero_ps()), one, oy);
+
+            __m128 r = Select(useX, ox, oy);
+            __m128 theta = Select(
+                useX,
+                _mm_mul_ps(quarterPi, _mm_div_ps(oy, safeX)),
+                _mm_sub_ps(_mm_set1_ps(0.5f * glm::pi<f32>()), _mm_mul_ps(quarterPi, _mm_div_ps(ox, safeY)))
+            );
+
+            __m128 sin, cos;
+            SinCos4(theta, sin, cos);
+
+            x = _mm_mul_ps(r, cos);
+            y = _mm_mul_ps(r, sin);
+        }
+#endif
+
+    }
+
+    auto Sampler::Sample2D(u32 dimension) const -> glm::vec2
+    {
+        if (m_Type == SamplerType::Sobol) {
+            u32 seed = HashCombine(HashCombine(HashCombine(Hash(m_Seed), m_Pixel.x), m_Pixel.y), dimension);
+            return ScrambledSobol2D(m_Index, seed);
+        }
+
+        // Every pixel walks the same sequence; a Cranley-Patterson shift from the mask, looked up at a
+        // different offset per dimension and axis, decorrelates neighbours into blue-noise error
+        u32 seed = HashCombine(Hash(m_Seed), dimension);
+        glm::vec2 u = ScrambledSobol2D(m_Index, seed);
+
+        u32 shiftX = HashCombine(seed, 2);
+        u32 shiftY = HashCombine(seed, 3);
+        glm::vec2 offset(
+            BlueNoise(m_Pixel.x + shiftX, m_Pixel.y + (shiftX >> 16)),
+            BlueNoise(m_Pixel.x + shiftY, m_Pixel.y + (shiftY >> 16))
+        );
+
+        u += offset;
+        if (u.x >= 1.0f) u.x -= 1.0f;
+        if (u.y >= 1.0f) u.y -= 1.0f;
+
+        return u;
+    }
+
+    auto Sampler::FillVec2(std::span<Sampler> samplers, std::span<glm::vec2> out) -> void
+    {
+        usize i = 0;
+
+#if KYBER_SIMD_SSE
+        for (; i + 4 <= samplers.size(); i += 4) {
+            Sampler* s = &samplers[i];
+
+            bool counterBased = true;
+            bool sobol = true;
+            for (u32 lane = 0; lane < 4; ++lane) {
+                counterBased &= s[lane].m_Type == SamplerType::Random;
+                sobol &= s[lane].m_Type == SamplerType::Sobol;
+            }
+
+            if (sobol) {
+                __m128i seed = _mm_setr_epi32(
+                    static_cast<i32>(Hash(s[0].m_Seed)), static_cast<i32>(Hash(s[1].m_Seed)),
+                    static_cast<i32>(Hash(s[2].m_Seed)), static_cast<i32>(Hash(s[3].m_Seed))
+                );
+                seed = HashCombine4(seed, _mm_setr_epi32(
+                    static_cast<i32>(s[0].m_Pixel.x), static_cast<i32>(s[1].m_Pixel.x),
+                    static_cast<i32>(s[2].m_Pixel.x), static_cast<i32>(s[3].m_Pixel.x)
+                ));
+                seed = HashCombine4(seed, _mm_setr_epi32(
+                    static_cast<i32>(s[0].m_Pixel.y), static_cast<i32>(s[1].m_Pixel.y),
+                    static_cast<i32>(s[2].m_Pixel.y), static_cast<i32>(s[3].m_Pixel.y)
+                ));
+                seed = HashCombine4(seed, _mm_setr_epi32(
+                    static_cast<i32>(s[0].m_Dimension++), static_cast<i32>(s[1].m_Dimension++),
+                    static_cast<i32>(s[2].m_Dimension++), static_cast<i32>(s[3].m_Dimension++)
+                ));
+
+                __m128i index = _mm_setr_epi32(
+                    static_cast<i32>(s[0].m_Index), static_cast<i32>(s[1].m_Index),
+                    static_cast<i32>(s[2].m_Index), static_cast<i32>(s[3].m_Index)
+                );
+
+                __m128 x, y;
+                ScrambledSobol2Dx4(index, seed, x, y);
+                StoreVec2x4(&out[i], x, y);
+                continue;
+            }
+
+            // Blue noise looks its shift up in the mask per lane, so it stays scalar
+            if (!counterBased) {
+                for (u32 lane = 0; lane < 4; ++lane) {
+                    out[i + lane] = s[lane].Vec2();
+                }
+                continue;
+            }
+
+            __m128i keyX = _mm_setr_epi32(
+                static_cast<i32>(s[0].m_Key.x), static_cast<i32>(s[1].m_Key.x),
+                static_cast<i32>(s[2].m_Key.x), static_cast<i32>(s[3].m_Key.x)
+            );
+            __m128i keyY = _mm_setr_epi32(
+                static_cast<i32>(s[0].m_Key.y), static_cast<i32>(s[1].m_Key.y),
+                static_cast<i32>(s[2].m_Key.y), static_cast<i32>(s[3].m_Key.y)
+            );
+            __m128i counter = _mm_setr_epi32(
+                static_cast<i32>(2 * s[0].m_Dimension++), static_cast<i32>(2 * s[1].m_Dimension++),
+                static_cast<i32>(2 * s[2].m_Dimension++), static_cast<i32>(2 * s[3].m_Dimension++)
+            );
+
+            __m128 x = ToF32x4(CounterU32x4(keyX, keyY, counter));
+            __m128 y = ToF32x4(CounterU32x4(keyX, keyY, _mm_add_epi32(counter, _mm_set1_epi32(1))));
+            StoreVec2x4(&out[i], x, y);
+        }
+#endif
+
+        for (; i < samplers.size(); ++i) {
+            out[i] = samplers[i].Vec2();
+        }
+    }
+
+    auto SquareToUnitDisk(std::span<const glm::vec2> u, std::span<glm::vec2> out) -> void
+    {
+        usize i = 0;
+
+#if KYBER_SIMD_SSE
+        for (; i + 4 <= u.size(); i += 4) {
+            __m128 ux, uy, x, y;
+            LoadVec2x4(&u[i], ux, uy);
+            Disk4(ux, uy, x, y);
+            StoreVec2x4(&out[i], x, y);
+        }
+#endif
+
+        for (; i < u.size(); ++i) {
+            out[i] = SquareToUnitDisk(u[i]);
+        }
+    }
+
+}
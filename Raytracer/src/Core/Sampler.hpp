@@ -0,0 +1,126 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+
+#include "RNG.hpp"
+
+namespace Kyber {
+
+    enum class SamplerType : u8
+    {
+        // Independent draws from a counter-based hash of (pixel, sample, dimension, seed)
+        Random,
+
+        // Owen-scrambled Sobol (0,2)-sequence, shuffled per pixel and per dimension
+        Sobol,
+
+        // One scrambled Sobol sequence shared by every pixel, rotated per pixel by a blue-noise mask
+        BlueNoise
+    };
+
+    // Maps [0, 1)^2 to the unit disk with Shirley's concentric mapping, which keeps strata intact
+    inline auto SquareToUnitDisk(const glm::vec2& u) -> glm::vec2
+    {
+        glm::vec2 offset = 2.0f * u - 1.0f;
+        if (offset.x == 0.0f && offset.y == 0.0f) return glm::vec2(0.0f);
+
+        f32 r, theta;
+        if (std::fabs(offset.x) > std::fabs(offset.y)) {
+            r = offset.x;
+            theta = 0.25f * glm::pi<f32>() * (offset.y / offset.x);
+        } else {
+            r = offset.y;
+            theta = 0.5f * glm::pi<f32>() - 0.25f * glm::pi<f32>() * (offset.x / offset.y);
+        }
+
+        return r * glm::vec2(std::cos(theta), std::sin(theta));
+    }
+
+    // Maps [0, 1)^2 to the surface of the unit sphere
+    inline auto SquareToUnitSphere(const glm::vec2& u) -> glm::vec3
+    {
+        f32 z = 1.0f - 2.0f * u.x;
+        f32 r = std::sqrt(std::max(0.0f, 1.0f - z * z));
+        f32 phi = 2.0f * glm::pi<f32>() * u.y;
+
+        return glm::vec3(r * std::cos(phi), r * std::sin(phi), z);
+    }
+
+    // Array version of the disk mapping for the batched lens samples. Branch-free, with a polynomial
+    // sincos, four lanes at a time where SSE is available; results match the scalar form to float rounding.
+    auto SquareToUnitDisk(std::span<const glm::vec2> u, std::span<glm::vec2> out) -> void;
+
+    // Hands out the sample dimensions of one pixel sample. Every consumer draws through the sampler,
+    // so a low-discrepancy sequence lines the same decision up across the samples of a pixel. All
+    // types are pure functions of their key, so a task renders the same bits on any thread.
+    class Sampler
+    {
+    public:
+        // The camera takes the first two dimensions (pixel jitter, lens); each bounce then gets a fixed
+        // block so a skipped draw at one bounce doesn't shift the dimensions of the next
+        static constexpr u32 CameraDimensions = 2;
+        static constexpr u32 BounceDimensions = 8;
+
+    public:
+        Sampler() = default;
+
+        Sampler(SamplerType type, const glm::uvec2& pixel, u32 sampleIndex, u32 seed = 0)
+            : m_Type(type), m_Pixel(pixel), m_Index(sampleIndex), m_Seed(seed)
+            , m_Key(CounterRNG::Key(glm::uvec4(pixel.x, pixel.y, sampleIndex, seed)))
+        {
+        }
+
+        auto StartBounce(u32 depth) -> void
+        {
+            m_Dimension = CameraDimensions + depth * BounceDimensions;
+        }
+
+        auto F32() -> f32
+        {
+            if (m_Type == SamplerType::Random) return CounterRNG::ToF32(CounterRNG::U32(m_Key, 2 * m_Dimension++));
+            return Sample2D(m_Dimension++).x;
+        }
+
+        auto Vec2() -> glm::vec2
+        {
+            if (m_Type == SamplerType::Random) {
+                u32 counter = 2 * m_Dimension++;
+                return glm::vec2(CounterRNG::ToF32(CounterRNG::U32(m_Key, counter)), CounterRNG::ToF32(CounterRNG::U32(m_Key, counter + 1)));
+            }
+            return Sample2D(m_Dimension++);
+        }
+
+        // Draws the next 2D dimension of every sampler into out. Random and Sobol samplers are hashed
+        // four at a time and give the same bits as calling Vec2 on each; blue noise goes one at a time.
+        static auto FillVec2(std::span<Sampler> samplers, std::span<glm::vec2> out) -> void;
+
+        auto UnitVec3() -> glm::vec3
+        {
+            return SquareToUnitSphere(Vec2());
+        }
+
+        auto InUnitSphere() -> glm::vec3
+        {
+            glm::vec3 direction = UnitVec3();
+            return direction * std::cbrt(F32());
+        }
+
+        auto InUnitDisk() -> glm::vec2
+        {
+            return SquareToUnitDisk(Vec2());
+        }
+
+    private:
+        auto Sample2D(u32 dimension) const -> glm::vec2;
+
+    private:
+        SamplerType m_Type { SamplerType::Random };
+        glm::uvec2 m_Pixel { 0 };
+        u32 m_Index { 0 };
+        u32 m_Seed { 0 };
+        glm::uvec2 m_Key { 0 };
+        u32 m_Dimension { 0 };
+    };
+
+}
@@ -1,14 +1,50 @@
 #include "TileScheduler.hpp"
 
+#include <glm/gtc/constants.hpp>
+
+#include "AdaptiveSampling.hpp"
+
 namespace Kyber {
 
-    auto TileScheduler::Reset(u32 width, u32 height, u32 tileSize, u32 totalSamples) -> void
+    namespace {
+
+        auto TileOrderKey(TileOrder order, u32 col, u32 row, u32 cols, u32 rows) -> u64
+        {
+            switch (order) {
+                case TileOrder::Morton:
+                    return Morton2D(col, row);
+                case TileOrder::Hilbert:
+                    return HilbertIndex(std::bit_ceil(std::max(cols, rows)), col, row);
+                case TileOrder::Spiral: {
+                    // Doubled offsets from the centre are whole numbers; ring in the high word, angle in the low
+                    i32 dx = 2 * static_cast<i32>(col) - static_cast<i32>(cols - 1);
+                    i32 dy = 2 * static_cast<i32>(row) - static_cast<i32>(rows - 1);
+                    u64 ring = static_cast<u64>(std::max(std::abs(dx), std::abs(dy)));
+
+                    f32 angle = std::atan2(static_cast<f32>(dy), static_cast<f32>(dx)) + glm::pi<f32>();
+                    u64 turn = static_cast<u64>(angle / (2.0f * glm::pi<f32>()) * static_cast<f32>(1u << 30));
+
+                    return (ring << 32) | turn;
+                }
+                case TileOrder::RowMajor:
+                default:
+                    return static_cast<u64>(row) * cols + col;
+            }
+        }
+
+    }
+
+    auto TileScheduler::Reset(u32 width, u32 height, u32 tileSize, u32 totalSamples, const AdaptiveSamplingOptions& adaptive, TileOrder order) -> void
     {
+        std::scoped_lock<std::mutex> lock(m_Mutex);
+
         m_Tiles.clear();
 
         u32 cols = (width + tileSize - 1) / tileSize;
         u32 rows = (height + tileSize - 1) / tileSize;
 
+        std::vector<std::pair<u64, Tile>> ordered;
+
         for (u32 row = 0; row < rows; ++row) {
             for (u32 col = 0; col < cols; ++col) {
                 u32 x = col * tileSize;
@@ -16,36 +52,121 @@ namespace Kyber {
                 u32 w = std::min(tileSize, width - x);
                 u32 h = std::min(tileSize, height - y);
 
-                m_Tiles.push_back({x, y, w, h});
+                ordered.push_back({ TileOrderKey(order, col, row, cols, rows), Tile { x, y, w, h } });
             }
         }
 
-        m_TotalTiles = m_Tiles.size();
-        m_TotalSamples = totalSamples;
-        m_Offset.store(0);
+        // Rounds walk the tiles by index, so sorting them here is all the ordering needs
+        std::ranges::stable_sort(ordered, {}, &std::pair<u64, Tile>::first);
+        for (const auto& [key, tile] : ordered) {
+            m_Tiles.push_back(tile);
+        }
+
+        // Without adaptive sampling no tile retires early, and every round is one pass over all tiles
+        if (adaptive.Enabled) {
+            m_MinSamples = std::min(adaptive.MinSamples, totalSamples);
+            m_MaxSamples = totalSamples * std::max(adaptive.MaxSampleScale, 1u);
+            m_Threshold = adaptive.Threshold;
+        } else {
+            m_MinSamples = totalSamples;
+            m_MaxSamples = totalSamples;
+            m_Threshold = 0.0f;
+        }
+
+        usize tileCount = m_Tiles.size();
+        m_TileSamples.assign(tileCount, 0);
+        m_TileErrors.assign(tileCount, std::numeric_limits<f32>::infinity());
+        m_InFlight.assign(tileCount, 0);
+        m_Retired.assign(tileCount, m_MaxSamples == 0);
+
+        m_Round.clear();
+        m_RoundOffset = 0;
+        m_TasksInFlight = 0;
+
+        m_Issued.store(0);
+        m_Remaining.store(static_cast<u64>(tileCount) * m_MaxSamples);
+        m_ActiveTiles.store(m_MaxSamples > 0 ? static_cast<u32>(tileCount) : 0);
     }
     
     auto TileScheduler::GetTask(RenderTask& task) -> bool
     {
-        u64 currentIndex = m_Offset.fetch_add(1, std::memory_order_relaxed);
+        std::unique_lock<std::mutex> lock(m_Mutex);
 
-        u64 totalTasks = static_cast<u64>(m_TotalTiles) * static_cast<u64>(m_TotalSamples);
-        if (currentIndex >= totalTasks) return false;
+        while (true) {
+            // Skip tiles that retired after the round was built
+            while (m_RoundOffset < m_Round.size() && m_Retired[m_Round[m_RoundOffset]]) {
+                m_RoundOffset++;
+            }
 
-        u32 samplePass = static_cast<u32>(currentIndex / m_TotalTiles);
-        u32 tileIndex = static_cast<u32>(currentIndex % m_TotalTiles);
+            if (m_RoundOffset == m_Round.size()) {
+                StartRound();
+            }
+
+            if (m_RoundOffset < m_Round.size()) break;
+
+            // Every tile left is in flight; wait for one to come back unless nothing is left at all
+            if (m_TasksInFlight == 0) return false;
+            m_TaskCompleted.wait(lock);
+        }
+
+        u32 tileIndex = m_Round[m_RoundOffset++];
 
         task.tile = m_Tiles[tileIndex];
-        task.sample = samplePass + 1;
+        task.sample = ++m_TileSamples[tileIndex];
+        task.tileIndex = tileIndex;
+
+        m_InFlight[tileIndex] = 1;
+        m_TasksInFlight++;
+
+        m_Issued.fetch_add(1, std::memory_order_relaxed);
+        m_Remaining.fetch_sub(1, std::memory_order_relaxed);
 
         return true;
     }
 
+    auto TileScheduler::Complete(const RenderTask& task, f32 error) -> void
+    {
+        {
+            std::scoped_lock<std::mutex> lock(m_Mutex);
+
+            u32 tileIndex = task.tileIndex;
+            m_InFlight[tileIndex] = 0;
+            m_TasksInFlight--;
+            m_TileErrors[tileIndex] = error;
+
+            u32 samples = m_TileSamples[tileIndex];
+            if (!m_Retired[tileIndex] && (samples >= m_MaxSamples || (samples >= m_MinSamples && error < m_Threshold))) {
+                Retire(tileIndex);
+            }
+        }
+
+        m_TaskCompleted.notify_all();
+    }
+
     auto TileScheduler::GetProgress() -> f32
     {
-        u64 current = m_Offset.load(std::memory_order_relaxed);
-        u64 total = static_cast<u64>(m_TotalTiles) * m_TotalSamples;
-        return total > 0 ? (static_cast<f32>(current) / static_cast<f32>(total)) : 0.0f;
+        u64 issued = m_Issued.load(std::memory_order_relaxed);
+        u64 total = issued + m_Remaining.load(std::memory_order_relaxed);
+        return total > 0 ? (static_cast<f32>(issued) / static_cast<f32>(total)) : 0.0f;
+    }
+
+    auto TileScheduler::StartRound() -> void
+    {
+        m_Round.clear();
+        m_RoundOffset = 0;
+
+        for (u32 i = 0; i < m_Tiles.size(); ++i) {
+            if (!m_Retired[i] && !m_InFlight[i] && m_TileSamples[i] < m_MaxSamples) {
+                m_Round.push_back(i);
+            }
+        }
+    }
+
+    auto TileScheduler::Retire(u32 tileIndex) -> void
+    {
+        m_Retired[tileIndex] = 1;
+        m_Remaining.fetch_sub(m_MaxSamples - m_TileSamples[tileIndex], std::memory_order_relaxed);
+        m_ActiveTiles.fetch_sub(1, std::memory_order_relaxed);
     }
 
 }
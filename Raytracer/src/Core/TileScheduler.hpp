@@ -1,7 +1,23 @@
 #pragma once
 
+#include "Morton.hpp"
+
 namespace Kyber {
 
+    struct AdaptiveSamplingOptions;
+
+    // Order tiles are handed out in. Curves keep concurrently rendered tiles close together on screen,
+    // so the workers walk the same parts of the scene and share more of the BVH in the last-level cache.
+    enum class TileOrder : u8
+    {
+        RowMajor,
+        Morton,
+        Hilbert,
+
+        // Ring by ring outwards from the centre of the image, where the subject usually is
+        Spiral
+    };
+
     struct Tile
     {
         u32 x;
@@ -14,24 +30,92 @@ namespace Kyber {
     {
         Tile tile;
         u32 sample;
+        u32 tileIndex;
     };
 
+    // Calls f(x, y) for every cell of a width x height grid, row by row or along a Morton curve. The
+    // curve covers the enclosing power-of-two square and skips the cells outside the grid.
+    template <typename F>
+    inline auto ForEachPixel(u32 width, u32 height, bool morton, F&& f) -> void
+    {
+        if (!morton) {
+            for (u32 y = 0; y < height; ++y) {
+                for (u32 x = 0; x < width; ++x) {
+                    f(x, y);
+                }
+            }
+            return;
+        }
+
+        u32 side = std::bit_ceil(std::max(width, height));
+        for (u32 code = 0; code < side * side; ++code) {
+            u32 x = CompactBits2D(code);
+            u32 y = CompactBits2D(code >> 1);
+            if (x < width && y < height) f(x, y);
+        }
+    }
+
+    // Hands out one sample pass of one tile at a time, in rounds over the tiles still rendering. A tile
+    // is never handed out again while a pass of it is in flight, so it can retire as soon as the pass
+    // that converged it completes, and retirement depends only on the tile's own samples.
     class TileScheduler
     {
     public:
         TileScheduler() = default;
         ~TileScheduler() = default;
 
-        auto Reset(u32 width, u32 height, u32 tileSize, u32 totalSamples) -> void;
+        auto Reset(u32 width, u32 height, u32 tileSize, u32 totalSamples, const AdaptiveSamplingOptions& adaptive, TileOrder order) -> void;
         auto GetTask(RenderTask& task) -> bool;
 
+        // Reports a finished pass with the tile's error estimate, or infinity if there is none yet
+        auto Complete(const RenderTask& task, f32 error) -> void;
+
         auto GetProgress() -> f32;
 
+        // Tiles that may still receive samples
+        auto GetActiveTiles() -> u32
+        {
+            return m_ActiveTiles.load(std::memory_order_relaxed);
+        }
+
+        auto GetTileCount() const -> u32
+        {
+            return static_cast<u32>(m_Tiles.size());
+        }
+
+        auto GetIssuedSamples() -> u64
+        {
+            return m_Issued.load(std::memory_order_relaxed);
+        }
+
+    private:
+        auto StartRound() -> void;
+        auto Retire(u32 tileIndex) -> void;
+
     private:
         std::vector<Tile> m_Tiles;
-        std::atomic<u64> m_Offset { 0 };
-        usize m_TotalTiles { 0 };
-        u32 m_TotalSamples { 0 };
+
+        // Per tile: passes handed out, latest error, and whether a pass is in flight or it has retired
+        std::vector<u32> m_TileSamples;
+        std::vector<f32> m_TileErrors;
+        std::vector<u8> m_InFlight;
+        std::vector<u8> m_Retired;
+
+        std::vector<u32> m_Round;
+        usize m_RoundOffset { 0 };
+        u32 m_TasksInFlight { 0 };
+
+        std::mutex m_Mutex;
+        std::condition_variable m_TaskCompleted;
+
+        u32 m_MinSamples { 0 };
+        u32 m_MaxSamples { 0 };
+        f32 m_Threshold { 0.0f };
+
+        // Samples handed out, and the most that may still follow from tiles that haven't retired
+        std::atomic<u64> m_Issued { 0 };
+        std::atomic<u64> m_Remaining { 0 };
+        std::atomic<u32> m_ActiveTiles { 0 };
     };
 
 }
@@ -8,9 +8,18 @@
 
 namespace Kyber {
 
-    class Material;
+    // What traversal keeps for the closest hit so far; the surface is only evaluated once it is final
+    struct PrimitiveHit
+    {
+        f32 t;
+
+        // Index of the primitive inside the hittable that reported the hit, and the index that
+        // primitive reported in turn (the bottom-level primitive of an instance)
+        u32 primitive { 0 };
+        u32 subPrimitive { 0 };
+    };
 
-    struct HitRecord
+    struct SurfaceInteraction
     {
         glm::vec3 p;
         glm::vec3 n;
@@ -23,7 +32,8 @@ namespace Kyber {
             n = frontFace ? normal : -normal;
         }
 
-        std::shared_ptr<Material> material;
+        // Index into the scene's material table
+        u32 material { 0 };
     };
 
     class Hittable
@@ -31,8 +41,17 @@ namespace Kyber {
     public:
         virtual ~Hittable() = default;
 
-        virtual auto Hit(const Ray& ray, Interval clip) const -> std::optional<HitRecord> = 0;
+        virtual auto Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit> = 0;
+        virtual auto Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction = 0;
+        virtual auto Occluded(const Ray& ray, Interval clip) const -> bool = 0;
         virtual auto GetBBox() const -> AABB = 0;
+
+        // Closest hit with its surface evaluated
+        auto Hit(const Ray& ray, Interval clip) const -> std::optional<SurfaceInteraction>
+        {
+            if (auto hit = Intersect(ray, clip)) return Interact(ray, *hit);
+            return std::nullopt;
+        }
     };
 
 }
@@ -7,33 +7,45 @@ namespace Kyber {
         m_Hittables.assign(hittables.begin(), hittables.end());
     }
 
-    auto HittableList::Push(const std::shared_ptr<Hittable>& hittable)
+    auto HittableList::Push(const std::shared_ptr<Hittable>& hittable) -> void
     {
         m_Hittables.push_back(hittable);
         m_BBox = AABB(m_BBox, hittable->GetBBox());
     }
 
-    auto HittableList::Push(const std::vector<std::shared_ptr<Hittable>>& hittables)
+    auto HittableList::Push(const std::vector<std::shared_ptr<Hittable>>& hittables) -> void
     {
         for (const auto& hittable : hittables) {
             Push(hittable);
         }
     }
 
-    auto HittableList::Hit(const Ray& ray, Interval clip) const -> std::optional<HitRecord>
+    auto HittableList::Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit>
     {
-        std::optional<HitRecord> record;
-        bool hitAny = false;
+        std::optional<PrimitiveHit> closest;
 
-        for (const auto& hittable : m_Hittables) {
-            if (auto hit = hittable->Hit(ray, clip)) {
-                hitAny = true;
+        for (u32 i = 0; i < m_Hittables.size(); ++i) {
+            if (auto hit = m_Hittables[i]->Intersect(ray, clip)) {
                 clip.max = hit->t;
-                record = hit;
+                closest = PrimitiveHit { .t = hit->t, .primitive = i, .subPrimitive = hit->primitive };
             }
         }
 
-        return record;
+        return closest;
+    }
+
+    auto HittableList::Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction
+    {
+        return m_Hittables[hit.primitive]->Interact(ray, PrimitiveHit { .t = hit.t, .primitive = hit.subPrimitive });
+    }
+
+    auto HittableList::Occluded(const Ray& ray, Interval clip) const -> bool
+    {
+        for (const auto& hittable : m_Hittables) {
+            if (hittable->Occluded(ray, clip)) return true;
+        }
+
+        return false;
     }
 
 }
@@ -12,10 +12,12 @@ namespace Kyber {
 
         virtual ~HittableList() = default;
 
-        auto Push(const std::shared_ptr<Hittable>& hittable);
-        auto Push(const std::vector<std::shared_ptr<Hittable>>& hittables);
+        auto Push(const std::shared_ptr<Hittable>& hittable) -> void;
+        auto Push(const std::vector<std::shared_ptr<Hittable>>& hittables) -> void;
 
-        virtual auto Hit(const Ray& ray, Interval clip) const -> std::optional<HitRecord> override;
+        virtual auto Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit> override;
+        virtual auto Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction override;
+        virtual auto Occluded(const Ray& ray, Interval clip) const -> bool override;
         virtual auto GetBBox() const -> AABB override
         {
             return m_BBox;
@@ -0,0 +1,68 @@
+#include "Instance.hpp"
+
+namespace Kyber {
+
+    Instance::Instance(const std::shared_ptr<const Hittable>& geometry, const glm::mat4& transform)
+        : m_Geometry(geometry)
+    {
+        SetTransform(transform);
+    }
+
+    auto Instance::SetTransform(const glm::mat4& transform) -> void
+    {
+        m_ObjectToWorld = transform;
+        m_WorldToObject = glm::inverse(transform);
+        m_NormalToWorld = glm::transpose(glm::mat3(m_WorldToObject));
+
+        // World bounds enclose the eight transformed corners of the object bounds
+        AABB local = m_Geometry->GetBBox();
+
+        glm::vec3 lo(std::numeric_limits<f32>::infinity());
+        glm::vec3 hi(-std::numeric_limits<f32>::infinity());
+        for (u32 corner = 0; corner < 8; ++corner) {
+            glm::vec3 p(
+                (corner & 1) ? local.x.max : local.x.min,
+                (corner & 2) ? local.y.max : local.y.min,
+                (corner & 4) ? local.z.max : local.z.min
+            );
+
+            glm::vec3 world = glm::vec3(m_ObjectToWorld * glm::vec4(p, 1.0f));
+            lo = glm::min(lo, world);
+            hi = glm::max(hi, world);
+        }
+
+        m_BBox = AABB(lo, hi);
+    }
+
+    auto Instance::Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit>
+    {
+        // The object-space direction is left unnormalized so t is the same in both spaces
+        return m_Geometry->Intersect(ToObject(ray), clip);
+    }
+
+    auto Instance::Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction
+    {
+        SurfaceInteraction interaction = m_Geometry->Interact(ToObject(ray), hit);
+
+        glm::vec3 outward = interaction.frontFace ? interaction.n : -interaction.n;
+
+        interaction.p = ray.At(interaction.t);
+        interaction.SetFaceNormal(ray, glm::normalize(m_NormalToWorld * outward));
+
+        return interaction;
+    }
+
+    auto Instance::Occluded(const Ray& ray, Interval clip) const -> bool
+    {
+        return m_Geometry->Occluded(ToObject(ray), clip);
+    }
+
+    auto Instance::ToObject(const Ray& ray) const -> Ray
+    {
+        return Ray(
+            glm::vec3(m_WorldToObject * glm::vec4(ray.origin, 1.0f)),
+            glm::vec3(m_WorldToObject * glm::vec4(ray.direction, 0.0f))
+        );
+    }
+
+}
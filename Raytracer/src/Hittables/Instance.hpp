@@ -0,0 +1,43 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Hittable.hpp"
+
+namespace Kyber {
+
+    // Places shared bottom-level geometry in the world through an affine transform
+    class Instance final : public Hittable
+    {
+    public:
+        Instance(const std::shared_ptr<const Hittable>& geometry, const glm::mat4& transform);
+        virtual ~Instance() = default;
+
+        virtual auto Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit> override;
+        virtual auto Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction override;
+        virtual auto Occluded(const Ray& ray, Interval clip) const -> bool override;
+        virtual auto GetBBox() const -> AABB override
+        {
+            return m_BBox;
+        }
+
+        // The owning top-level BVH must be rebuilt afterwards
+        auto SetTransform(const glm::mat4& transform) -> void;
+
+        auto GetTransform() const -> const glm::mat4& { return m_ObjectToWorld; }
+        auto GetGeometry() const -> const std::shared_ptr<const Hittable>& { return m_Geometry; }
+
+    private:
+        auto ToObject(const Ray& ray) const -> Ray;
+
+    private:
+        std::shared_ptr<const Hittable> m_Geometry;
+
+        glm::mat4 m_ObjectToWorld;
+        glm::mat4 m_WorldToObject;
+        glm::mat3 m_NormalToWorld;
+
+        AABB m_BBox;
+    };
+
+}
@@ -2,7 +2,7 @@
 
 namespace Kyber {
 
-    Sphere::Sphere(const glm::vec3& center, f32 radius, const std::shared_ptr<Material>& material)
+    Sphere::Sphere(const glm::vec3& center, f32 radius, u32 material)
         : m_Center(center)
         , m_Radius(std::max(radius, 0.0f))
         , m_Material(material)
@@ -11,7 +11,7 @@ namespace Kyber {
         m_BBox = AABB(center - rvec, center + rvec);
     }
 
-    auto Sphere::Hit(const Ray& ray, Interval clip) const -> std::optional<HitRecord>
+    auto Sphere::Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit>
     {
         glm::vec3 oc = ray.origin - m_Center;
 
@@ -30,13 +30,34 @@ namespace Kyber {
             if (!clip.Surrounds(root)) return std::nullopt;
         }
 
-        HitRecord record;
-        record.t = root;
-        record.p = ray.At(root);
-        record.SetFaceNormal(ray, (record.p - m_Center) / m_Radius);
-        record.material = m_Material;
+        return PrimitiveHit { .t = root };
+    }
+
+    auto Sphere::Occluded(const Ray& ray, Interval clip) const -> bool
+    {
+        glm::vec3 oc = ray.origin - m_Center;
+
+        f32 a = glm::dot(ray.direction, ray.direction);
+        f32 b = 2.0f * glm::dot(oc, ray.direction);
+        f32 c = glm::dot(oc, oc) - m_Radius * m_Radius;
+
+        f32 discriminant = b * b - 4.0f * a * c;
+        if (discriminant < 0.0f) return false;
+
+        f32 sqrtd = glm::sqrt(discriminant);
+
+        return clip.Surrounds((-b - sqrtd) / (2.0f * a)) || clip.Surrounds((-b + sqrtd) / (2.0f * a));
+    }
+
+    auto Sphere::Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction
+    {
+        SurfaceInteraction interaction;
+        interaction.t = hit.t;
+        interaction.p = ray.At(hit.t);
+        interaction.SetFaceNormal(ray, (interaction.p - m_Center) / m_Radius);
+        interaction.material = m_Material;
 
-        return record;
+        return interaction;
     }
 
 }
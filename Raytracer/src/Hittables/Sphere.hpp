@@ -9,20 +9,26 @@ namespace Kyber {
     class Sphere final : public Hittable
     {
     public:
-        Sphere(const glm::vec3& center, f32 radius, const std::shared_ptr<Material>& material);
+        Sphere(const glm::vec3& center, f32 radius, u32 material);
         virtual ~Sphere() = default;
 
-        virtual auto Hit(const Ray& ray, Interval clip) const -> std::optional<HitRecord> override;
+        virtual auto Intersect(const Ray& ray, Interval clip) const -> std::optional<PrimitiveHit> override;
+        virtual auto Interact(const Ray& ray, const PrimitiveHit& hit) const -> SurfaceInteraction override;
+        virtual auto Occluded(const Ray& ray, Interval clip) const -> bool override;
         virtual auto GetBBox() const -> AABB override
         {
             return m_BBox;
         }
 
+        auto GetCenter() const -> const glm::vec3& { return m_Center; }
+        auto GetRadius() const -> f32 { return m_Radius; }
+        auto GetMaterial() const -> u32 { return m_Material; }
+
     private:
         glm::vec3 m_Center;
         f32 m_Radius { 0 };
 
-        std::shared_ptr<Material> m_Material;
+        u32 m_Material { 0 };
         AABB m_BBox;
     };
 
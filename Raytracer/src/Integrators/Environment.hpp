@@ -0,0 +1,14 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+namespace Kyber {
+
+    inline auto SkyRadiance(const glm::vec3& direction) -> glm::vec3
+    {
+        glm::vec3 dir = glm::normalize(direction);
+        f32 t = 0.5f * (dir.y + 1.0f);
+        return glm::mix(glm::vec3(1.0f), glm::vec3(0.5f, 0.7f, 1.0f), t);
+    }
+
+}
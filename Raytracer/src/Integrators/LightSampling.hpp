@@ -0,0 +1,134 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Core/Sampler.hpp"
+#include "Hittables/Hittable.hpp"
+#include "Materials/Material.hpp"
+
+namespace Kyber {
+
+    struct SphereLight
+    {
+        glm::vec3 center;
+        f32 radius;
+        glm::vec3 emission;
+    };
+
+    using LightTable = std::span<const SphereLight>;
+
+    struct LightSample
+    {
+        glm::vec3 wi;
+        f32 distance;
+        f32 pdf;
+    };
+
+    // 1 - cos(thetaMax) of the cone the sphere subtends from p, or zero from inside it. Written in
+    // terms of sin^2 so small, distant lights don't cancel to nothing.
+    inline auto SphereLightCone(const SphereLight& light, const glm::vec3& p) -> f32
+    {
+        glm::vec3 toCenter = light.center - p;
+        f32 dist2 = glm::dot(toCenter, toCenter);
+        f32 radius2 = light.radius * light.radius;
+        if (dist2 <= radius2) return 0.0f;
+
+        f32 sinThetaMax2 = radius2 / dist2;
+        f32 cosThetaMax = std::sqrt(std::max(0.0f, 1.0f - sinThetaMax2));
+        return sinThetaMax2 / (1.0f + cosThetaMax);
+    }
+
+    // Maps u uniformly onto the cone the sphere subtends from p
+    inline auto SampleSphereLight(const SphereLight& light, const glm::vec3& p, const glm::vec2& u) -> std::optional<LightSample>
+    {
+        f32 oneMinusCosMax = SphereLightCone(light, p);
+        if (oneMinusCosMax <= 0.0f) return std::nullopt;
+
+        glm::vec3 toCenter = light.center - p;
+        f32 dist = glm::length(toCenter);
+        glm::vec3 w = toCenter / dist;
+
+        glm::vec3 helper = std::fabs(w.x) > 0.9f ? glm::vec3(0.0f, 1.0f, 0.0f) : glm::vec3(1.0f, 0.0f, 0.0f);
+        glm::vec3 tangent = glm::normalize(glm::cross(helper, w));
+        glm::vec3 bitangent = glm::cross(w, tangent);
+
+        f32 cosTheta = 1.0f - u.x * oneMinusCosMax;
+        f32 sinTheta = std::sqrt(std::max(0.0f, 1.0f - cosTheta * cosTheta));
+        f32 phi = u.y * 2.0f * glm::pi<f32>();
+
+        glm::vec3 wi = glm::normalize(tangent * (std::cos(phi) * sinTheta) + bitangent * (std::sin(phi) * sinTheta) + w * cosTheta);
+
+        // Nearest root of the ray against the sphere; the discriminant only dips below zero at the
+        // cone's edge through rounding
+        f32 b = glm::dot(wi, toCenter);
+        f32 c = dist * dist - light.radius * light.radius;
+        f32 distance = b - std::sqrt(std::max(0.0f, b * b - c));
+
+        return LightSample {
+            .wi = wi,
+            .distance = distance,
+            .pdf = 1.0f / (2.0f * glm::pi<f32>() * oneMinusCosMax)
+        };
+    }
+
+    // Density SampleSphereLight gives any direction that lands on the light
+    inline auto SphereLightPdf(const SphereLight& light, const glm::vec3& p) -> f32
+    {
+        f32 oneMinusCosMax = SphereLightCone(light, p);
+        if (oneMinusCosMax <= 0.0f) return 0.0f;
+
+        return 1.0f / (2.0f * glm::pi<f32>() * oneMinusCosMax);
+    }
+
+    inline auto PowerHeuristic(f32 pdf, f32 otherPdf) -> f32
+    {
+        f32 a = pdf * pdf;
+        f32 b = otherPdf * otherPdf;
+        return a > 0.0f ? a / (a + b) : 0.0f;
+    }
+
+    // MIS weight for emission found by BSDF sampling, given the density the previous bounce picked
+    // the direction with. Specular bounces and camera rays pass zero and keep all of it.
+    inline auto EmitterWeight(LightTable lights, const DiffuseLight& emitter, const glm::vec3& origin, f32 bsdfPdf) -> f32
+    {
+        if (bsdfPdf <= 0.0f) return 1.0f;
+
+        f32 lightPdf = SphereLightPdf(lights[emitter.GetLight()], origin) / static_cast<f32>(lights.size());
+        return PowerHeuristic(bsdfPdf, lightPdf);
+    }
+
+    // Next-event estimation: one light picked uniformly, one direction towards it, one shadow ray.
+    // Weighted against the BSDF sampling of the same vertex with the power heuristic.
+    template <typename TMaterial>
+    inline auto EstimateDirect(const Hittable& aggregate, LightTable lights, const TMaterial& material, const Ray& ray, const SurfaceInteraction& hit, Sampler& sampler) -> glm::vec3
+    {
+        if constexpr (!EvaluableMaterial<TMaterial>) {
+            return glm::vec3(0.0f);
+        } else {
+            if (lights.empty()) return glm::vec3(0.0f);
+
+            u32 index = std::min(static_cast<u32>(sampler.F32() * static_cast<f32>(lights.size())), static_cast<u32>(lights.size()) - 1);
+            const SphereLight& light = lights[index];
+
+            auto sample = SampleSphereLight(light, hit.p, sampler.Vec2());
+            if (!sample) return glm::vec3(0.0f);
+
+            BSDFEvaluation bsdf = material.Evaluate(ray, hit, sample->wi);
+            if (bsdf.pdf <= 0.0f) return glm::vec3(0.0f);
+
+            // Stop just short of the light so its own surface doesn't count as a blocker
+            if (aggregate.Occluded(Ray(hit.p, sample->wi), Interval(0.0001f, sample->distance * 0.999f))) {
+                return glm::vec3(0.0f);
+            }
+
+            f32 lightPdf = sample->pdf / static_cast<f32>(lights.size());
+            return bsdf.f * light.emission * (PowerHeuristic(lightPdf, bsdf.pdf) / lightPdf);
+        }
+    }
+
+    inline auto EstimateDirect(const Hittable& aggregate, LightTable lights, const Material& material, const Ray& ray, const SurfaceInteraction& hit, Sampler& sampler) -> glm::vec3
+    {
+        return std::visit([&](const auto& m) { return EstimateDirect(aggregate, lights, m, ray, hit, sampler); }, material);
+    }
+
+}
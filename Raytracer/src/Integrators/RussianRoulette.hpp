@@ -0,0 +1,31 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <glm/gtx/component_wise.hpp>
+
+#include "Core/Sampler.hpp"
+
+namespace Kyber {
+
+    struct RussianRouletteOptions
+    {
+        bool Enabled { true };
+
+        // Bounces that always continue before roulette starts
+        u32 MinDepth { 3 };
+    };
+
+    // Survival follows the throughput's largest channel, capped so that lossless paths (glass) still end.
+    // Survivors are divided by that probability, which keeps the estimate unbiased. Returns false if the path ends.
+    inline auto RussianRoulette(glm::vec3& throughput, u32 bounces, const RussianRouletteOptions& options, Sampler& sampler) -> bool
+    {
+        if (!options.Enabled || bounces < options.MinDepth) return true;
+
+        f32 survival = std::min(glm::compMax(throughput), 0.95f);
+        if (sampler.F32() >= survival) return false;
+
+        throughput /= survival;
+        return true;
+    }
+
+}
@@ -0,0 +1,349 @@
+#include "WavefrontIntegrator.hpp"
+
+#include "Core/Morton.hpp"
+#include "Integrators/Environment.hpp"
+
+namespace Kyber {
+
+    auto PathStream::Reserve(usize capacity) -> void
+    {
+        if (origin.size() >= capacity) return;
+
+        origin.resize(capacity);
+        direction.resize(capacity);
+        throughput.resize(capacity);
+        pdf.resize(capacity);
+        sampler.resize(capacity);
+        pixel.resize(capacity);
+        hit.resize(capacity);
+        alive.resize(capacity);
+    }
+
+    auto WavefrontIntegrator::Render(
+        const RenderTask& task,
+        const Camera& camera,
+        const Hittable& aggregate,
+        const Scene& scene,
+        const WavefrontOptions& options,
+        u32 stride,
+        std::span<glm::vec4> accumulator,
+        std::span<glm::vec4> halfAccumulator
+    ) -> Stats
+    {
+        Stats stats {};
+
+        Generate(task, camera, options);
+
+        for (u32 depth = 0; depth < options.MaxDepth && m_Paths.count > 0; ++depth) {
+            stats.Rays += m_Paths.count;
+
+            // Primary rays are already coherent in pixel order
+            if (depth == 0) {
+                Extend(aggregate);
+            } else {
+                stats.SecondaryRays += m_Paths.count;
+
+                auto sortStart = std::chrono::steady_clock::now();
+                if (options.SortRays) {
+                    Sort();
+                }
+
+                auto extendStart = std::chrono::steady_clock::now();
+                Extend(aggregate);
+                auto extendEnd = std::chrono::steady_clock::now();
+
+                stats.SortTime += std::chrono::duration_cast<std::chrono::nanoseconds>(extendStart - sortStart).count();
+                stats.ExtendTime += std::chrono::duration_cast<std::chrono::nanoseconds>(extendEnd - extendStart).count();
+            }
+
+            auto shadeStart = std::chrono::steady_clock::now();
+            Shade(aggregate, scene, options, depth + 1);
+            stats.ShadeTime += std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - shadeStart).count();
+
+            Compact();
+        }
+
+        Accumulate(task, stride, accumulator, halfAccumulator);
+
+        return stats;
+    }
+
+    auto WavefrontIntegrator::Generate(const RenderTask& task, const Camera& camera, const WavefrontOptions& options) -> void
+    {
+        const Tile& tile = task.tile;
+        usize pixelCount = static_cast<usize>(tile.w) * tile.h;
+
+        m_Paths.Reserve(pixelCount);
+        m_Radiance.assign(pixelCount, glm::vec3(0.0f));
+
+        // Accumulated sample counts start at one
+        u32 index = 0;
+        ForEachPixel(tile.w, tile.h, options.MortonPixels, [&](u32 x, u32 y) {
+            m_Paths.sampler[index] = Sampler(options.Sampling, glm::uvec2(tile.x + x, tile.y + y), task.sample - 1, options.Seed);
+            m_Paths.pixel[index] = x + y * tile.w;
+            index++;
+        });
+
+        // Jitter and lens samples for the whole tile in two batched draws, then one batched disk mapping
+        std::span<Sampler> samplers(m_Paths.sampler.data(), pixelCount);
+        m_Jitter.resize(pixelCount);
+        m_Lens.resize(pixelCount);
+
+        Sampler::FillVec2(samplers, m_Jitter);
+        Sampler::FillVec2(samplers, m_Lens);
+        SquareToUnitDisk(m_Lens, m_Lens);
+
+        for (u32 i = 0; i < index; ++i) {
+            u32 x = tile.x + m_Paths.pixel[i] % tile.w;
+            u32 y = tile.y + m_Paths.pixel[i] / tile.w;
+            Ray ray = camera.GetRayFromDisk(x, y, m_Jitter[i] - 0.5f, m_Lens[i]);
+
+            m_Paths.origin[i] = ray.origin;
+            m_Paths.direction[i] = ray.direction;
+            m_Paths.throughput[i] = glm::vec3(1.0f);
+            m_Paths.pdf[i] = 0.0f;
+        }
+
+        m_Paths.count = index;
+    }
+
+    auto WavefrontIntegrator::Sort() -> void
+    {
+        const u32 count = m_Paths.count;
+        if (count < 2) return;
+
+        glm::vec3 lo(std::numeric_limits<f32>::infinity());
+        glm::vec3 hi(-std::numeric_limits<f32>::infinity());
+        for (u32 i = 0; i < count; ++i) {
+            lo = glm::min(lo, m_Paths.origin[i]);
+            hi = glm::max(hi, m_Paths.origin[i]);
+        }
+
+        // Bounds of the live origins rather than the scene, so huge primitives don't flatten the grid
+        glm::vec3 extent = hi - lo;
+        glm::vec3 scale(
+            extent.x > 0.0f ? 1.0f / extent.x : 0.0f,
+            extent.y > 0.0f ? 1.0f / extent.y : 0.0f,
+            extent.z > 0.0f ? 1.0f / extent.z : 0.0f
+        );
+
+        // 24-bit key: octant on top, then the 21 most significant Morton bits
+        m_SortKeys.resize(count);
+        m_SortScratch.resize(count);
+        for (u32 i = 0; i < count; ++i) {
+            const glm::vec3& d = m_Paths.direction[i];
+            u32 octant = (d.x < 0.0f ? 4u : 0u) | (d.y < 0.0f ? 2u : 0u) | (d.z < 0.0f ? 1u : 0u);
+            u32 morton = Morton3D((m_Paths.origin[i] - lo) * scale);
+
+            u64 key = (octant << 21) | (morton >> 9);
+            m_SortKeys[i] = (key << 32) | i;
+        }
+
+        // LSD radix sort over the three key bytes, stable so equal keys keep generation order
+        for (u32 shift = 32; shift < 56; shift += 8) {
+            std::array<u32, 256> offsets {};
+            for (u64 key : m_SortKeys) {
+                offsets[(key >> shift) & 0xFF]++;
+            }
+
+            u32 sum = 0;
+            for (u32& offset : offsets) {
+                u32 bucket = offset;
+                offset = sum;
+                sum += bucket;
+            }
+
+            for (u64 key : m_SortKeys) {
+                m_SortScratch[offsets[(key >> shift) & 0xFF]++] = key;
+            }
+
+            std::swap(m_SortKeys, m_SortScratch);
+        }
+
+        m_Scratch.Reserve(count);
+        for (u32 i = 0; i < count; ++i) {
+            u32 src = static_cast<u32>(m_SortKeys[i]);
+            m_Scratch.origin[i] = m_Paths.origin[src];
+            m_Scratch.direction[i] = m_Paths.direction[src];
+            m_Scratch.throughput[i] = m_Paths.throughput[src];
+            m_Scratch.pdf[i] = m_Paths.pdf[src];
+            m_Scratch.sampler[i] = m_Paths.sampler[src];
+            m_Scratch.pixel[i] = m_Paths.pixel[src];
+        }
+
+        std::swap(m_Paths.origin, m_Scratch.origin);
+        std::swap(m_Paths.direction, m_Scratch.direction);
+        std::swap(m_Paths.throughput, m_Scratch.throughput);
+        std::swap(m_Paths.pdf, m_Scratch.pdf);
+        std::swap(m_Paths.sampler, m_Scratch.sampler);
+        std::swap(m_Paths.pixel, m_Scratch.pixel);
+    }
+
+    auto WavefrontIntegrator::Extend(const Hittable& aggregate) -> void
+    {
+        const Interval clip(0.0001f, std::numeric_limits<f32>::infinity());
+
+        for (u32 i = 0; i < m_Paths.count; ++i) {
+            m_Paths.hit[i] = aggregate.Intersect(Ray(m_Paths.origin[i], m_Paths.direction[i]), clip);
+        }
+    }
+
+    template <typename TMaterial>
+    auto WavefrontIntegrator::ShadePath(const Hittable& aggregate, const Scene& scene, const TMaterial& material, u32 path, const SurfaceInteraction& interaction, const WavefrontOptions& options, u32 bounces) -> void
+    {
+        Ray ray(m_Paths.origin[path], m_Paths.direction[path]);
+        glm::vec3& radiance = m_Radiance[m_Paths.pixel[path]];
+
+        Sampler& sampler = m_Paths.sampler[path];
+        sampler.StartBounce(bounces - 1);
+
+        if constexpr (std::is_same_v<TMaterial, DiffuseLight>) {
+            f32 weight = options.NextEventEstimation ? EmitterWeight(scene.GetLights(), material, ray.origin, m_Paths.pdf[path]) : 1.0f;
+            radiance += m_Paths.throughput[path] * material.Emitted(interaction) * weight;
+        } else if constexpr (EvaluableMaterial<TMaterial>) {
+            if (options.NextEventEstimation) {
+                radiance += m_Paths.throughput[path] * EstimateDirect(aggregate, scene.GetLights(), material, ray, interaction, sampler);
+            }
+        }
+
+        ScatterPath(path, material.Scatter(ray, interaction, sampler), options.Roulette, bounces);
+    }
+
+    template <typename TMaterial>
+    auto WavefrontIntegrator::ShadeBatch(const Hittable& aggregate, const Scene& scene, std::span<const u32> paths, const WavefrontOptions& options, u32 bounces) -> void
+    {
+        const MaterialTable materials = scene.GetMaterials();
+
+        // Every path in the batch has the same material type, so there is nothing left to dispatch on
+        for (u32 i : paths) {
+            const SurfaceInteraction& interaction = m_Interactions[i];
+            ShadePath(aggregate, scene, *std::get_if<TMaterial>(&materials[interaction.material]), i, interaction, options, bounces);
+        }
+    }
+
+    auto WavefrontIntegrator::Shade(const Hittable& aggregate, const Scene& scene, const WavefrontOptions& options, u32 bounces) -> void
+    {
+        const MaterialTable materials = scene.GetMaterials();
+        const f32 sky = scene.GetSkyIntensity();
+
+        if (!options.SortByMaterial) {
+            for (u32 i = 0; i < m_Paths.count; ++i) {
+                Ray ray(m_Paths.origin[i], m_Paths.direction[i]);
+                const auto& hit = m_Paths.hit[i];
+
+                if (!hit) {
+                    m_Radiance[m_Paths.pixel[i]] += m_Paths.throughput[i] * SkyRadiance(ray.direction) * sky;
+                    m_Paths.alive[i] = 0;
+                    continue;
+                }
+
+                SurfaceInteraction interaction = aggregate.Interact(ray, *hit);
+                std::visit([&](const auto& material) {
+                    ShadePath(aggregate, scene, material, i, interaction, options, bounces);
+                }, materials[interaction.material]);
+            }
+            return;
+        }
+
+        // Evaluate every surface first, then bucket the hits by material type with a counting sort
+        m_Interactions.resize(m_Paths.count);
+        m_ShadeOrder.resize(m_Paths.count);
+
+        std::array<u32, MaterialTypeCount + 1> offsets {};
+
+        for (u32 i = 0; i < m_Paths.count; ++i) {
+            Ray ray(m_Paths.origin[i], m_Paths.direction[i]);
+            const auto& hit = m_Paths.hit[i];
+
+            if (!hit) {
+                m_Radiance[m_Paths.pixel[i]] += m_Paths.throughput[i] * SkyRadiance(ray.direction) * sky;
+                m_Paths.alive[i] = 0;
+                continue;
+            }
+
+            m_Interactions[i] = aggregate.Interact(ray, *hit);
+            offsets[materials[m_Interactions[i].material].index() + 1]++;
+        }
+
+        for (u32 type = 0; type < MaterialTypeCount; ++type) {
+            offsets[type + 1] += offsets[type];
+        }
+
+        std::array<u32, MaterialTypeCount> cursor;
+        std::copy_n(offsets.begin(), MaterialTypeCount, cursor.begin());
+
+        for (u32 i = 0; i < m_Paths.count; ++i) {
+            if (!m_Paths.hit[i]) continue;
+            m_ShadeOrder[cursor[materials[m_Interactions[i].material].index()]++] = i;
+        }
+
+        [&]<usize... Type>(std::index_sequence<Type...>) {
+            (ShadeBatch<std::variant_alternative_t<Type, Material>>(
+                aggregate,
+                scene,
+                std::span<const u32>(m_ShadeOrder.data() + offsets[Type], offsets[Type + 1] - offsets[Type]),
+                options,
+                bounces
+            ), ...);
+        }(std::make_index_sequence<MaterialTypeCount>{});
+    }
+
+    auto WavefrontIntegrator::ScatterPath(u32 path, const std::optional<ScatterData>& scatter, const RussianRouletteOptions& roulette, u32 bounces) -> void
+    {
+        if (!scatter) {
+            m_Paths.alive[path] = 0;
+            return;
+        }
+
+        m_Paths.throughput[path] *= scatter->attenuation;
+        m_Paths.pdf[path] = scatter->pdf;
+        if (!RussianRoulette(m_Paths.throughput[path], bounces, roulette, m_Paths.sampler[path])) {
+            m_Paths.alive[path] = 0;
+            return;
+        }
+
+        m_Paths.origin[path] = scatter->scattered.origin;
+        m_Paths.direction[path] = scatter->scattered.direction;
+        m_Paths.alive[path] = 1;
+    }
+
+    auto WavefrontIntegrator::Compact() -> void
+    {
+        // Stable in-place compaction keeps surviving paths in generation order
+        u32 live = 0;
+        for (u32 i = 0; i < m_Paths.count; ++i) {
+            if (!m_Paths.alive[i]) continue;
+
+            if (live != i) {
+                m_Paths.origin[live] = m_Paths.origin[i];
+                m_Paths.direction[live] = m_Paths.direction[i];
+                m_Paths.throughput[live] = m_Paths.throughput[i];
+                m_Paths.pdf[live] = m_Paths.pdf[i];
+                m_Paths.sampler[live] = m_Paths.sampler[i];
+                m_Paths.pixel[live] = m_Paths.pixel[i];
+            }
+            live++;
+        }
+
+        m_Paths.count = live;
+    }
+
+    auto WavefrontIntegrator::Accumulate(const RenderTask& task, u32 stride, std::span<glm::vec4> accumulator, std::span<glm::vec4> halfAccumulator) const -> void
+    {
+        const Tile& tile = task.tile;
+        bool oddSample = task.sample % 2 == 1;
+
+        for (u32 y = 0; y < tile.h; ++y) {
+            for (u32 x = 0; x < tile.w; ++x) {
+                usize index = (tile.x + x) + static_cast<usize>(tile.y + y) * stride;
+                accumulator[index] += glm::vec4(m_Radiance[x + y * tile.w], 0.0f);
+                accumulator[index].a = static_cast<f32>(task.sample);
+
+                if (oddSample) {
+                    halfAccumulator[index] += glm::vec4(m_Radiance[x + y * tile.w], 1.0f);
+                }
+            }
+        }
+    }
+
+}
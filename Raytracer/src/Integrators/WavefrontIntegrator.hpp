@@ -0,0 +1,114 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Camera.hpp"
+#include "Scene.hpp"
+#include "Hittables/Hittable.hpp"
+#include "Materials/Material.hpp"
+#include "Integrators/RussianRoulette.hpp"
+#include "Core/Sampler.hpp"
+#include "Core/TileScheduler.hpp"
+
+namespace Kyber {
+
+    // Structure-of-arrays state for a batch of in-flight paths
+    struct PathStream
+    {
+        std::vector<glm::vec3> origin;
+        std::vector<glm::vec3> direction;
+        std::vector<glm::vec3> throughput;
+
+        // Density the last bounce was sampled with; zero after the camera and specular bounces
+        std::vector<f32> pdf;
+        std::vector<Sampler> sampler;
+        std::vector<u32> pixel;
+        std::vector<std::optional<PrimitiveHit>> hit;
+        std::vector<u8> alive;
+
+        u32 count { 0 };
+
+        auto Reserve(usize capacity) -> void;
+    };
+
+    struct WavefrontOptions
+    {
+        u32 MaxDepth { 8 };
+
+        SamplerType Sampling { SamplerType::Sobol };
+        u32 Seed { 0 };
+
+        // Generate camera rays along a Morton curve over the tile instead of in scanlines
+        bool MortonPixels { true };
+
+        // Reorder secondary rays by direction octant and origin Morton code before traversal
+        bool SortRays { false };
+
+        // Shade hits in one batch per material type instead of in path order
+        bool SortByMaterial { false };
+
+        // Sample a light at every non-specular hit and weight it against BSDF sampling
+        bool NextEventEstimation { true };
+
+        RussianRouletteOptions Roulette;
+    };
+
+    class WavefrontIntegrator
+    {
+    public:
+        struct Stats
+        {
+            u64 Rays;
+            u64 SecondaryRays;
+
+            // Nanoseconds spent sorting and extending secondary rays
+            u64 SortTime;
+            u64 ExtendTime;
+
+            // Nanoseconds spent shading, including any material grouping
+            u64 ShadeTime;
+        };
+
+    public:
+        WavefrontIntegrator() = default;
+        ~WavefrontIntegrator() = default;
+
+        auto Render(
+            const RenderTask& task,
+            const Camera& camera,
+            const Hittable& aggregate,
+            const Scene& scene,
+            const WavefrontOptions& options,
+            u32 stride,
+            std::span<glm::vec4> accumulator,
+            std::span<glm::vec4> halfAccumulator
+        ) -> Stats;
+
+    private:
+        auto Generate(const RenderTask& task, const Camera& camera, const WavefrontOptions& options) -> void;
+        auto Sort() -> void;
+        auto Extend(const Hittable& aggregate) -> void;
+        auto Shade(const Hittable& aggregate, const Scene& scene, const WavefrontOptions& options, u32 bounces) -> void;
+        auto ScatterPath(u32 path, const std::optional<ScatterData>& scatter, const RussianRouletteOptions& roulette, u32 bounces) -> void;
+
+        template <typename TMaterial>
+        auto ShadePath(const Hittable& aggregate, const Scene& scene, const TMaterial& material, u32 path, const SurfaceInteraction& interaction, const WavefrontOptions& options, u32 bounces) -> void;
+
+        template <typename TMaterial>
+        auto ShadeBatch(const Hittable& aggregate, const Scene& scene, std::span<const u32> paths, const WavefrontOptions& options, u32 bounces) -> void;
+        auto Compact() -> void;
+        auto Accumulate(const RenderTask& task, u32 stride, std::span<glm::vec4> accumulator, std::span<glm::vec4> halfAccumulator) const -> void;
+
+    private:
+        PathStream m_Paths;
+        PathStream m_Scratch;
+        std::vector<u64> m_SortKeys;
+        std::vector<u64> m_SortScratch;
+        std::vector<glm::vec3> m_Radiance;
+        std::vector<glm::vec2> m_Jitter;
+        std::vector<glm::vec2> m_Lens;
+        std::vector<SurfaceInteraction> m_Interactions;
+        std::vector<u32> m_ShadeOrder;
+    };
+
+}
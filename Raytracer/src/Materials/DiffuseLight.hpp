@@ -0,0 +1,35 @@
+#pragma once
+
+#include "ScatterData.hpp"
+
+namespace Kyber {
+
+    // One-sided emitter that absorbs everything reaching it. Each light in the scene gets its own
+    // instance, so a hit can recover which light it landed on.
+    class DiffuseLight
+    {
+    public:
+        DiffuseLight(const glm::vec3& emission, u32 light)
+            : m_Emission(emission), m_Light(light)
+        {
+        }
+
+        auto Scatter(const Ray&, const SurfaceInteraction&, Sampler&) const -> std::optional<ScatterData>
+        {
+            return std::nullopt;
+        }
+
+        auto Emitted(const SurfaceInteraction& hit) const -> glm::vec3
+        {
+            return hit.frontFace ? m_Emission : glm::vec3(0.0f);
+        }
+
+        auto GetEmission() const -> const glm::vec3& { return m_Emission; }
+        auto GetLight() const -> u32 { return m_Light; }
+
+    private:
+        glm::vec3 m_Emission;
+        u32 m_Light;
+    };
+
+}
@@ -1,17 +1,46 @@
 #pragma once
 
-#include "Material.hpp"
+#include <glm/gtx/component_wise.hpp>
+
+#include "ScatterData.hpp"
 
 namespace Kyber {
 
-    class Lambertian final : public Material
+    class Lambertian
     {
     public:
-        Lambertian(const glm::vec3& albedo);
-        virtual ~Lambertian() = default;
+        Lambertian(const glm::vec3& albedo)
+            : m_Albedo(albedo)
+        {
+        }
+
+        auto Scatter(const Ray&, const SurfaceInteraction& hit, Sampler& sampler) const -> std::optional<ScatterData>
+        {
+            glm::vec3 direction = hit.n + sampler.UnitVec3();
+
+            if (glm::compMax(direction) < std::numeric_limits<f32>::epsilon()) {
+                direction = hit.n;
+            }
+
+            // Cosine-weighted, so albedo is already f * cos / pdf
+            return ScatterData {
+                .scattered = Ray(hit.p, direction),
+                .attenuation = m_Albedo,
+                .pdf = std::max(glm::dot(hit.n, glm::normalize(direction)), 0.0f) * glm::one_over_pi<f32>()
+            };
+        }
+
+        auto Evaluate(const Ray&, const SurfaceInteraction& hit, const glm::vec3& wi) const -> BSDFEvaluation
+        {
+            f32 cosine = glm::dot(hit.n, wi);
+            if (cosine <= 0.0f) return BSDFEvaluation { glm::vec3(0.0f), 0.0f };
+
+            return BSDFEvaluation {
+                .f = m_Albedo * cosine * glm::one_over_pi<f32>(),
+                .pdf = cosine * glm::one_over_pi<f32>()
+            };
+        }
 
-        virtual auto Scatter(const Ray& ray, const HitRecord& hit) const -> std::optional<ScatterData> override;
-    
     private:
         glm::vec3 m_Albedo;
     };
@@ -1,23 +1,31 @@
 #pragma once
 
-#include <glm/glm.hpp>
-
-#include "Containers/Ray.hpp"
-#include "Hittables/Hittable.hpp"
+#include "Lambertian.hpp"
+#include "Metal.hpp"
+#include "Dielectric.hpp"
+#include "DiffuseLight.hpp"
 
 namespace Kyber {
 
-    struct ScatterData
-    {
-        Ray scattered;
-        glm::vec3 attenuation;
+    // The material set is closed, so a hit dispatches on the variant tag into inlined scatter code
+    // instead of making a virtual call
+    using Material = std::variant<Lambertian, Metal, Dielectric, DiffuseLight>;
+
+    inline constexpr u32 MaterialTypeCount = static_cast<u32>(std::variant_size_v<Material>);
+
+    // Materials that can evaluate their BSDF for an arbitrary direction take part in light sampling;
+    // the rest only scatter into delta or near-delta lobes
+    template <typename TMaterial>
+    concept EvaluableMaterial = requires(const TMaterial& m, const Ray& ray, const SurfaceInteraction& hit, const glm::vec3& wi) {
+        { m.Evaluate(ray, hit, wi) } -> std::same_as<BSDFEvaluation>;
     };
 
-    class Material
+    inline auto Scatter(const Material& material, const Ray& ray, const SurfaceInteraction& hit, Sampler& sampler) -> std::optional<ScatterData>
     {
-    public:
-        virtual ~Material() = default;
-        virtual auto Scatter(const Ray& ray, const HitRecord& hit) const -> std::optional<ScatterData> = 0;
-    };
+        return std::visit([&](const auto& m) { return m.Scatter(ray, hit, sampler); }, material);
+    }
+
+    // View of the scene's materials; surfaces refer to them by index
+    using MaterialTable = std::span<const Material>;
 
 }
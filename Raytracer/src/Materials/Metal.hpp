@@ -1,17 +1,30 @@
 #pragma once
 
-#include "Material.hpp"
+#include "ScatterData.hpp"
 
 namespace Kyber {
 
-    class Metal final : public Material
+    class Metal
     {
     public:
-        Metal(const glm::vec3& albedo, f32 fuzz);
-        virtual ~Metal() = default;
+        Metal(const glm::vec3& albedo, f32 fuzz)
+            : m_Albedo(albedo), m_Fuzz(std::max(0.0f, std::min(1.0f, fuzz)))
+        {
+        }
+
+        auto Scatter(const Ray& ray, const SurfaceInteraction& hit, Sampler& sampler) const -> std::optional<ScatterData>
+        {
+            glm::vec3 reflected = glm::reflect(glm::normalize(ray.direction), hit.n);
+            reflected = glm::normalize(reflected) + (m_Fuzz * sampler.InUnitSphere());
+
+            if (glm::dot(reflected, hit.n) < 0.0f) return std::nullopt;
+
+            return ScatterData {
+                .scattered = Ray(hit.p, reflected),
+                .attenuation = m_Albedo
+            };
+        }
 
-        virtual auto Scatter(const Ray& ray, const HitRecord& hit) const -> std::optional<ScatterData> override;
-    
     private:
         glm::vec3 m_Albedo;
         f32 m_Fuzz { 0.0f };
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+#include "Containers/Ray.hpp"
+#include "Hittables/Hittable.hpp"
+#include "Core/Sampler.hpp"
+
+namespace Kyber {
+
+    struct ScatterData
+    {
+        Ray scattered;
+        glm::vec3 attenuation;
+
+        // Solid-angle density of the scattered direction, left at zero for specular lobes
+        // that light sampling can never reach
+        f32 pdf { 0.0f };
+    };
+
+    // BSDF times cosine for a given direction, and the density Scatter would pick it with
+    struct BSDFEvaluation
+    {
+        glm::vec3 f;
+        f32 pdf;
+    };
+
+}
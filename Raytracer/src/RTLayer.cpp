@@ -2,28 +2,26 @@
 
 #include <imgui.h>
 #include <glm/gtc/type_ptr.hpp>
+#include <glm/gtc/matrix_transform.hpp>
 
 #include "Core/RNG.hpp"
 
+#include "Integrators/Environment.hpp"
+#include "Integrators/RussianRoulette.hpp"
+#include "Integrators/LightSampling.hpp"
+
 #include "Hittables/Sphere.hpp"
+#include "Hittables/Instance.hpp"
 
 #include "Materials/Material.hpp"
-#include "Materials/Lambertian.hpp"
-#include "Materials/Metal.hpp"
-#include "Materials/Dielectric.hpp"
 
 namespace Kyber {
 
     namespace {
 
-        auto Book1Scene() -> std::unique_ptr<BVH>
+        auto Book1Scene(const BVHBuildOptions& options, Scene& scene) -> std::unique_ptr<BVH>
         {
-            std::vector<std::shared_ptr<Hittable>> hittables;
-
-            hittables.push_back(std::make_shared<Sphere>(
-                glm::vec3(0.0f, -1000.0f, 0.0f), 1000.0f,
-                std::make_shared<Lambertian>(glm::vec3(0.5f))
-            ));
+            scene.AddSphere(glm::vec3(0.0f, -1000.0f, 0.0f), 1000.0f, scene.AddLambertian(glm::vec3(0.5f)));
 
             for (i32 a = -11; a < 11; ++a) {
                 for (i32 b = -11; b < 11; ++b) {
@@ -34,42 +32,113 @@ namespace Kyber {
 
                     if (choose < 0.8f) {
                         glm::vec3 albedo = RNG::Vec3() * RNG::Vec3();
-                        hittables.push_back(std::make_shared<Sphere>(
-                            center, 0.2f,
-                            std::make_shared<Lambertian>(albedo)
-                        ));
+                        scene.AddSphere(center, 0.2f, scene.AddLambertian(albedo));
                     } else if (choose < 0.95f) {
                         glm::vec3 albedo = RNG::Vec3(0.5f, 1.0f);
                         f32 fuzz = RNG::F32(0.0f, 0.5f);
-                        hittables.push_back(std::make_shared<Sphere>(
-                            center, 0.2f,
-                            std::make_shared<Metal>(albedo, fuzz)
-                        ));
+                        scene.AddSphere(center, 0.2f, scene.AddMetal(albedo, fuzz));
                     } else {
-                        hittables.push_back(std::make_shared<Sphere>(
-                            center, 0.2f,
-                            std::make_shared<Dielectric>(1.5f)
-                        ));
+                        scene.AddSphere(center, 0.2f, scene.AddDielectric(1.5f));
                     }
                 }
             }
 
-            hittables.push_back(std::make_shared<Sphere>(
-                glm::vec3(0.0f, 1.0f, 0.0f), 1.0f,
-                std::make_shared<Dielectric>(1.5f)
-            ));
+            scene.AddSphere(glm::vec3(0.0f, 1.0f, 0.0f), 1.0f, scene.AddDielectric(1.5f));
+            scene.AddSphere(glm::vec3(-4.0f, 1.0f, 0.0f), 1.0f, scene.AddLambertian(glm::vec3(0.4f, 0.2f, 0.1f)));
+            scene.AddSphere(glm::vec3(4.0f, 1.0f, 0.0f), 1.0f, scene.AddMetal(glm::vec3(0.7f, 0.6f, 0.5f), 0.0f));
 
-            hittables.push_back(std::make_shared<Sphere>(
-                glm::vec3(-4.0f, 1.0f, 0.0f), 1.0f,
-                std::make_shared<Lambertian>(glm::vec3(0.4f, 0.2f, 0.1f))
-            ));
+            return BVH::Create(scene, options);
+        }
+
+        // A smaller Book 1 field at night, lit only by a few small emissive spheres
+        auto SphereLightsScene(const BVHBuildOptions& options, Scene& scene) -> std::unique_ptr<BVH>
+        {
+            scene.SetSkyIntensity(0.0f);
+
+            scene.AddSphere(glm::vec3(0.0f, -1000.0f, 0.0f), 1000.0f, scene.AddLambertian(glm::vec3(0.5f)));
+
+            for (i32 a = -6; a < 6; ++a) {
+                for (i32 b = -6; b < 6; ++b) {
+                    f32 choose = RNG::F32();
+                    glm::vec3 center(a + 0.9f * RNG::F32(), 0.2f, b + 0.9f * RNG::F32());
+
+                    if (glm::length(center - glm::vec3(4.0f, 0.2f, 0.0f)) < 0.9f) continue;
+
+                    if (choose < 0.85f) {
+                        glm::vec3 albedo = RNG::Vec3() * RNG::Vec3();
+                        scene.AddSphere(center, 0.2f, scene.AddLambertian(albedo));
+                    } else {
+                        glm::vec3 albedo = RNG::Vec3(0.5f, 1.0f);
+                        scene.AddSphere(center, 0.2f, scene.AddMetal(albedo, RNG::F32(0.0f, 0.5f)));
+                    }
+                }
+            }
+
+            scene.AddSphere(glm::vec3(0.0f, 1.0f, 0.0f), 1.0f, scene.AddDielectric(1.5f));
+            scene.AddSphere(glm::vec3(-4.0f, 1.0f, 0.0f), 1.0f, scene.AddLambertian(glm::vec3(0.4f, 0.2f, 0.1f)));
+            scene.AddSphere(glm::vec3(4.0f, 1.0f, 0.0f), 1.0f, scene.AddMetal(glm::vec3(0.7f, 0.6f, 0.5f), 0.0f));
+
+            scene.AddSphereLight(glm::vec3(2.0f, 4.0f, 3.0f), 0.3f, glm::vec3(60.0f, 52.0f, 40.0f));
+            scene.AddSphereLight(glm::vec3(-2.0f, 0.5f, 2.0f), 0.1f, glm::vec3(80.0f, 20.0f, 10.0f));
+            scene.AddSphereLight(glm::vec3(2.0f, 0.5f, -2.5f), 0.1f, glm::vec3(10.0f, 30.0f, 80.0f));
+
+            return BVH::Create(scene, options);
+        }
+
+        // Builds a small clump of spheres around the origin to be shared by many instances
+        auto SphereCluster(u32 count, u32 material) -> std::shared_ptr<BVH>
+        {
+            std::vector<std::shared_ptr<Hittable>> hittables;
+
+            for (u32 i = 0; i < count; ++i) {
+                glm::vec3 offset = RNG::InUnitSphere() * glm::vec3(0.25f, 0.15f, 0.25f);
+                offset.y += 0.2f;
+
+                hittables.push_back(std::make_shared<Sphere>(offset, RNG::F32(0.04f, 0.1f), material));
+            }
+
+            return BVH::Create(std::move(hittables));
+        }
+
+        // A grid of instanced clusters; memory scales with the unique clusters, not the instances.
+        // The clusters stay Hittables, so only the materials live in the scene.
+        auto InstancedFieldScene(const BVHBuildOptions& options, Scene& scene) -> std::unique_ptr<BVH>
+        {
+            const std::shared_ptr<BVH> clusters[] = {
+                SphereCluster(48, scene.AddLambertian(glm::vec3(0.8f, 0.3f, 0.2f))),
+                SphereCluster(48, scene.AddMetal(glm::vec3(0.8f, 0.8f, 0.9f), 0.1f)),
+                SphereCluster(48, scene.AddDielectric(1.5f)),
+                SphereCluster(48, scene.AddLambertian(glm::vec3(0.2f, 0.5f, 0.3f)))
+            };
+
+            std::vector<std::shared_ptr<Hittable>> hittables;
 
             hittables.push_back(std::make_shared<Sphere>(
-                glm::vec3(4.0f, 1.0f, 0.0f), 1.0f,
-                std::make_shared<Metal>(glm::vec3(0.7f, 0.6f, 0.5f), 0.0f)
+                glm::vec3(0.0f, -1000.0f, 0.0f), 1000.0f,
+                scene.AddLambertian(glm::vec3(0.5f))
             ));
 
-            return BVH::Create(std::move(hittables));
+            constexpr i32 GridSize = 100;
+            constexpr f32 Spacing = 0.8f;
+
+            for (i32 a = 0; a < GridSize; ++a) {
+                for (i32 b = 0; b < GridSize; ++b) {
+                    glm::vec3 position(
+                        (a - GridSize / 2) * Spacing + 0.3f * RNG::F32(),
+                        0.0f,
+                        (b - GridSize / 2) * Spacing + 0.3f * RNG::F32()
+                    );
+
+                    glm::mat4 transform = glm::translate(glm::mat4(1.0f), position);
+                    transform = glm::rotate(transform, RNG::F32(0.0f, 2.0f * glm::pi<f32>()), glm::vec3(0.0f, 1.0f, 0.0f));
+                    transform = glm::scale(transform, glm::vec3(RNG::F32(0.7f, 1.3f)));
+
+                    const auto& cluster = clusters[RNG::U32(0, 3)];
+                    hittables.push_back(std::make_shared<Instance>(cluster, transform));
+                }
+            }
+
+            return BVH::Create(std::move(hittables), options);
         }
 
         void ColoredTextCentered(ImVec4 color, std::string text)
@@ -95,7 +164,7 @@ namespace Kyber {
 
     RTLayer::RTLayer()
     {
-        m_Aggregate = Book1Scene();
+        LoadScene();
 
         m_Camera = std::make_unique<Camera>(
             m_Resolution.x,
@@ -109,6 +178,8 @@ namespace Kyber {
         );
 
         m_Accumulator.assign(m_Resolution.x * m_Resolution.y, glm::vec4(0.0f));
+        m_HalfAccumulator.assign(m_Resolution.x * m_Resolution.y, glm::vec4(0.0f));
+        m_Heatmap.assign(m_Resolution.x * m_Resolution.y, glm::vec4(0.0f));
         m_PostProcess = std::make_unique<PostProcess>(m_Resolution.x, m_Resolution.y);
     }
 
@@ -126,13 +197,20 @@ namespace Kyber {
     {
         auto tiles = m_RenderQueue.Flush();
         if (!tiles.empty()) {
-            m_PostProcess->UploadTiles(m_Accumulator, tiles);
-            m_PostProcess->Dispatch();
+            UploadView(tiles);
         }
 
         if (m_Running && m_Scheduler.GetProgress() >= 1.0f) {
             Stop();
             m_PostProcess->Save("Finished.png");
+
+            f32 samplesPerPixel = static_cast<f32>(m_Scheduler.GetIssuedSamples()) / static_cast<f32>(m_Scheduler.GetTileCount());
+            KINFO("Finished in {:.2f} s at {:.1f} samples per pixel on average", m_AccumulatedTime, samplesPerPixel);
+
+            // Throughput per ordering, to compare them on the same scene
+            const char* tileOrders[] = { "row major", "Morton", "Hilbert", "spiral" };
+            f32 mRaysPerSec = static_cast<f32>(m_TotalRayCount.load()) / 1'000'000.0f / std::max(m_AccumulatedTime, 1e-6f);
+            KINFO("{} tiles, {} pixels: {:.2f} MRays/s", tileOrders[static_cast<u32>(m_TileOrder)], m_MortonPixels ? "Morton" : "scanline", mRaysPerSec);
         }
     }
 
@@ -140,6 +218,20 @@ namespace Kyber {
     {
         ImGui::Begin("Viewport");
 
+        // The heatmap shows each pixel's error against the adaptive threshold; blue has converged
+        const char* views[] = { "Image", "Error Heatmap" };
+        ImGui::SetNextItemWidth(160.0f);
+        if (ImGui::Combo("View", (int*)&m_ViewMode, views, IM_ARRAYSIZE(views))) {
+            m_PostProcess->SetTonemapping(m_ViewMode == ViewMode::Image);
+
+            // Whole frame, cut into row bands so idle workers can share it
+            std::vector<Tile> bands;
+            for (u32 y = 0; y < m_Resolution.y; y += m_TileSize) {
+                bands.push_back(Tile { 0, y, m_Resolution.x, std::min(m_TileSize, m_Resolution.y - y) });
+            }
+            UploadView(bands);
+        }
+
         ImVec2 size = ImGui::GetContentRegionAvail();
 
         if (size.x > 0 && size.y > 0) {
@@ -254,9 +346,92 @@ namespace Kyber {
         if (ImGui::CollapsingHeader("Render Settings", ImGuiTreeNodeFlags_DefaultOpen)) {
             ImGui::BeginDisabled(true);
             settingsChanged |= ImGui::InputScalarN("Resolution", ImGuiDataType_U32, glm::value_ptr(m_Resolution), 2);
+            settingsChanged |= ImGui::DragInt("Tile Size", (int*)&m_TileSize, 1.0f, 16, 256);
+            ImGui::EndDisabled();
+
+            ImGui::BeginDisabled(m_Running);
+
+            // Curves keep the tiles in flight, and the pixels within a tile, close together on screen
+            const char* tileOrders[] = { "Row Major", "Morton", "Hilbert", "Spiral" };
+            settingsChanged |= ImGui::Combo("Tile Order", (int*)&m_TileOrder, tileOrders, IM_ARRAYSIZE(tileOrders));
+            settingsChanged |= ImGui::Checkbox("Morton Pixel Order", &m_MortonPixels);
+
             settingsChanged |= ImGui::InputScalar("Samples", ImGuiDataType_U32, &m_Samples);
             settingsChanged |= ImGui::SliderInt("Depth", (int*)&m_Depth, 1, 100);
-            settingsChanged |= ImGui::DragInt("Tile Size", (int*)&m_TileSize, 1.0f, 16, 256);
+
+            // Light sampling at diffuse hits, combined with BSDF sampling by MIS
+            settingsChanged |= ImGui::Checkbox("Next Event Estimation", &m_NextEventEstimation);
+
+            // Low-discrepancy samplers reach the same error with fewer samples per pixel
+            const char* samplers[] = { "Random", "Sobol (Owen)", "Blue Noise" };
+            settingsChanged |= ImGui::Combo("Sampler", (int*)&m_SamplerType, samplers, IM_ARRAYSIZE(samplers));
+
+            // Every sample is a pure function of (pixel, sample, dimension, seed), so a seed reproduces
+            // a frame exactly regardless of worker count or scheduling
+            settingsChanged |= ImGui::InputScalar("Seed", ImGuiDataType_U32, &m_Seed);
+
+            // Tiles stop once their error estimate falls below the threshold; noisy ones may run past
+            // the sample count, up to the given multiple of it
+            settingsChanged |= ImGui::Checkbox("Adaptive Sampling", &m_Adaptive.Enabled);
+            ImGui::BeginDisabled(!m_Adaptive.Enabled);
+            settingsChanged |= ImGui::DragFloat("Error Threshold", &m_Adaptive.Threshold, 0.0001f, 0.0005f, 0.1f, "%.4f", ImGuiSliderFlags_Logarithmic);
+            settingsChanged |= ImGui::SliderInt("Min Samples", (int*)&m_Adaptive.MinSamples, 2, 256);
+            settingsChanged |= ImGui::SliderInt("Max Sample Scale", (int*)&m_Adaptive.MaxSampleScale, 1, 16);
+            ImGui::EndDisabled();
+
+            // Weak paths are ended at random past the minimum depth; survivors are reweighted
+            settingsChanged |= ImGui::Checkbox("Russian Roulette", &m_Roulette.Enabled);
+            ImGui::BeginDisabled(!m_Roulette.Enabled);
+            settingsChanged |= ImGui::SliderInt("Roulette Min Depth", (int*)&m_Roulette.MinDepth, 1, 16);
+            ImGui::EndDisabled();
+
+            const char* scenes[] = { "Book 1", "Instanced Field", "Sphere Lights" };
+            if (ImGui::Combo("Scene", (int*)&m_SceneType, scenes, IM_ARRAYSIZE(scenes))) {
+                LoadScene();
+                settingsChanged = true;
+            }
+
+            // Median, SAH and LBVH trade build time against trace time
+            const char* builders[] = { "Median", "SAH", "LBVH" };
+            int builder = static_cast<int>(m_BuildOptions.SplitMethod);
+            if (ImGui::Combo("BVH Builder", &builder, builders, IM_ARRAYSIZE(builders))) {
+                m_BuildOptions.SplitMethod = static_cast<BVHSplitMethod>(builder);
+                LoadScene();
+                settingsChanged = true;
+            }
+
+            if (ImGui::SliderInt("Treelet Passes", (int*)&m_BuildOptions.TreeletPasses, 0, 3)) {
+                LoadScene();
+                settingsChanged = true;
+            }
+
+            if (m_InstanceCount > 0 && ImGui::Button("Step Animation", ImVec2(ImGui::GetContentRegionAvail().x, 0.0f))) {
+                StepAnimation();
+                settingsChanged = true;
+            }
+
+            const char* aggregates[] = { "Binary BVH", "4-wide BVH", "4-wide BVH (Quantized)" };
+            settingsChanged |= ImGui::Combo("Traversal", (int*)&m_AggregateType, aggregates, IM_ARRAYSIZE(aggregates));
+
+            const char* integrators[] = { "Megakernel", "Wavefront" };
+            settingsChanged |= ImGui::Combo("Integrator", (int*)&m_IntegratorType, integrators, IM_ARRAYSIZE(integrators));
+
+            ImGui::BeginDisabled(m_IntegratorType != IntegratorType::Wavefront);
+            settingsChanged |= ImGui::Checkbox("Sort Secondary Rays", &m_SortRays);
+            settingsChanged |= ImGui::Checkbox("Sort Hits By Material", &m_SortByMaterial);
+            ImGui::EndDisabled();
+
+            // Packet traversal only exists for the binary BVH
+            ImGui::BeginDisabled(m_IntegratorType != IntegratorType::Megakernel || m_AggregateType != AggregateType::BVH2);
+
+            const u32 packetSizes[] = { 1, 4, 8, 16 };
+            const char* packetLabels[] = { "Off", "4 Rays", "8 Rays", "16 Rays" };
+            int packetIndex = static_cast<int>(std::ranges::find(packetSizes, m_PacketSize) - std::begin(packetSizes));
+            if (ImGui::Combo("Primary Packets", &packetIndex, packetLabels, IM_ARRAYSIZE(packetLabels))) {
+                m_PacketSize = packetSizes[packetIndex];
+                settingsChanged = true;
+            }
+            ImGui::EndDisabled();
             ImGui::EndDisabled();
         }
 
@@ -289,6 +464,59 @@ namespace Kyber {
                 ImGui::TableNextColumn(); ImGui::Text("Tree Depth");
                 ImGui::TableNextColumn(); ImGui::Text(": %u", stats.TreeDepth);
 
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("SAH Cost");
+                if (m_BuildOptions.TreeletPasses > 0) {
+                    ImGui::TableNextColumn(); ImGui::Text(": %.3f -> %.3f", stats.InitialSAHCost, stats.SAHCost);
+                } else {
+                    ImGui::TableNextColumn(); ImGui::Text(": %.3f", stats.SAHCost);
+                }
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("Build Time");
+                ImGui::TableNextColumn(); ImGui::Text(": %.2f ms", stats.BuildTime);
+
+                if (stats.RefitTime > 0.0f) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("Refit Time");
+                    ImGui::TableNextColumn(); ImGui::Text(": %.2f ms", stats.RefitTime);
+                }
+
+                usize nodeMemory = stats.NodeMemory;
+                if (m_AggregateType == AggregateType::BVH4) {
+                    nodeMemory = m_WideAggregate->GetStats().NodeMemory;
+                } else if (m_AggregateType == AggregateType::BVH4Compressed) {
+                    nodeMemory = m_CompressedAggregate->GetStats().NodeMemory;
+                }
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("Node Memory");
+                ImGui::TableNextColumn(); ImGui::Text(": %.2f KB", static_cast<f32>(nodeMemory) / 1024.0f);
+
+                if (m_InstanceCount > 0) {
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("Instances");
+                    ImGui::TableNextColumn(); ImGui::Text(": %u", m_InstanceCount);
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("BLAS Memory");
+                    ImGui::TableNextColumn(); ImGui::Text(": %.2f KB", static_cast<f32>(m_GeometryMemory) / 1024.0f);
+                }
+
+                auto sceneStats = m_Scene->GetStats();
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("Materials");
+                ImGui::TableNextColumn(); ImGui::Text(": %u (%u requested)", sceneStats.Materials, sceneStats.MaterialRequests);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("Lights");
+                ImGui::TableNextColumn(); ImGui::Text(": %u", sceneStats.Lights);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("Scene Memory");
+                ImGui::TableNextColumn(); ImGui::Text(": %.2f KB", static_cast<f32>(sceneStats.SphereMemory + sceneStats.MaterialMemory) / 1024.0f);
+
                 ImGui::EndTable();
             }
         }
@@ -343,6 +571,51 @@ namespace Kyber {
                 ImGui::TableNextColumn(); ImGui::Text("Ray Speed");
                 ImGui::TableNextColumn(); ImGui::Text(": %.2f MRays/s", mRaysPerSec);
 
+                u32 tileCount = m_Scheduler.GetTileCount();
+                f32 samplesPerPixel = tileCount > 0 ? static_cast<f32>(m_Scheduler.GetIssuedSamples()) / static_cast<f32>(tileCount) : 0.0f;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("Samples/Pixel");
+                ImGui::TableNextColumn(); ImGui::Text(": %.1f", samplesPerPixel);
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("Active Tiles");
+                ImGui::TableNextColumn(); ImGui::Text(": %u / %u", m_Scheduler.GetActiveTiles(), tileCount);
+
+                u64 pathCount = m_PathCount.load();
+                f32 pathLength = pathCount > 0 ? static_cast<f32>(rayCount) / static_cast<f32>(pathCount) : 0.0f;
+
+                ImGui::TableNextRow();
+                ImGui::TableNextColumn(); ImGui::Text("Path Length");
+                if (m_PreviousPathLength > 0.0f) {
+                    ImGui::TableNextColumn(); ImGui::Text(": %.2f (was %.2f)", pathLength, m_PreviousPathLength);
+                } else {
+                    ImGui::TableNextColumn(); ImGui::Text(": %.2f", pathLength);
+                }
+
+                // Summed over workers, so these compare against each other rather than wall time
+                u64 secondaryRays = m_SecondaryRayCount.load();
+                if (m_IntegratorType == IntegratorType::Wavefront && secondaryRays > 0) {
+                    f32 sortTime = static_cast<f32>(m_SortTime.load());
+                    f32 extendTime = static_cast<f32>(m_ExtendTime.load());
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("Sort Time");
+                    ImGui::TableNextColumn(); ImGui::Text(": %.1f ns/ray", sortTime / static_cast<f32>(secondaryRays));
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("Bounce Extend");
+                    ImGui::TableNextColumn(); ImGui::Text(": %.1f ns/ray", extendTime / static_cast<f32>(secondaryRays));
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("Sort Overhead");
+                    ImGui::TableNextColumn(); ImGui::Text(": %.1f%%", extendTime > 0.0f ? 100.0f * sortTime / (sortTime + extendTime) : 0.0f);
+
+                    ImGui::TableNextRow();
+                    ImGui::TableNextColumn(); ImGui::Text("Shade");
+                    ImGui::TableNextColumn(); ImGui::Text(": %.1f ns/ray", static_cast<f32>(m_ShadeTime.load()) / static_cast<f32>(std::max<u64>(rayCount, 1)));
+                }
+
                 ImGui::EndTable();
             }
         }
@@ -357,9 +630,9 @@ namespace Kyber {
 
         m_RenderStartTime = std::chrono::steady_clock::now();
 
-        u32 workerCount = std::max(1u, std::thread::hardware_concurrency() - 2);
-        for (u32 i = 0; i < workerCount; ++i) {
-            m_Workers.emplace_back(&RTLayer::WorkerThread, this);
+        // The pool outlives the render, so starting and stopping no longer creates threads
+        for (u32 i = 0; i < JobSystem::GetWorkerCount(); ++i) {
+            m_RenderJobs.Run([this]() { RenderJob(); });
         }
     }
 
@@ -372,87 +645,337 @@ namespace Kyber {
         }
 
         m_Running = false;
-
-        for (auto& worker : m_Workers) {
-            if (worker.joinable()) {
-                worker.join();
-            }
-        }
-
-        m_Workers.clear();
+        m_RenderJobs.Wait();
     }
 
     auto RTLayer::Reset() -> void
     {
         Stop();
 
-        m_Scheduler.Reset(m_Resolution.x, m_Resolution.y, m_TileSize, m_Samples);
+        // An odd minimum would compare halves of different sizes
+        m_Adaptive.MinSamples = std::max(m_Adaptive.MinSamples & ~1u, 2u);
+
+        m_Scheduler.Reset(m_Resolution.x, m_Resolution.y, m_TileSize, m_Samples, m_Adaptive, m_TileOrder);
         (void)m_RenderQueue.Flush();
 
         m_Accumulator.assign(m_Resolution.x * m_Resolution.y, glm::vec4(0.0f));
+        m_HalfAccumulator.assign(m_Resolution.x * m_Resolution.y, glm::vec4(0.0f));
+        m_Heatmap.assign(m_Resolution.x * m_Resolution.y, glm::vec4(0.0f));
         m_PostProcess->Clear();
 
+        if (m_PathCount > 0) {
+            m_PreviousPathLength = static_cast<f32>(m_TotalRayCount.load()) / static_cast<f32>(m_PathCount.load());
+        }
+
         m_TotalRayCount = 0;
+        m_PathCount = 0;
+        m_SecondaryRayCount = 0;
+        m_SortTime = 0;
+        m_ExtendTime = 0;
+        m_ShadeTime = 0;
         m_AccumulatedTime = 0.0f;
     }
 
-    auto RTLayer::WorkerThread() -> void
+    auto RTLayer::LoadScene() -> void
     {
+        Stop();
+
+        // Aggregates index into the scene, so they go first
+        m_CompressedAggregate.reset();
+        m_WideAggregate.reset();
+        m_Aggregate.reset();
+
+        // Scene layouts are random too; a fixed seed builds the same scene on every run
+        RNG::Seed(static_cast<u64>(m_SceneType) + 1);
+
+        switch (m_SceneType) {
+            case SceneType::InstancedField:
+                m_Scene = std::make_unique<Scene>(0, 8);
+                m_Aggregate = InstancedFieldScene(m_BuildOptions, *m_Scene);
+                break;
+            case SceneType::SphereLights:
+                m_Scene = std::make_unique<Scene>(12 * 12 + 7, 12 * 12 + 7);
+                m_Aggregate = SphereLightsScene(m_BuildOptions, *m_Scene);
+                break;
+            case SceneType::Book1:
+            default:
+                m_Scene = std::make_unique<Scene>(22 * 22 + 4, 22 * 22 + 4);
+                m_Aggregate = Book1Scene(m_BuildOptions, *m_Scene);
+                break;
+        }
+
+        auto sceneStats = m_Scene->GetStats();
+        KINFO("Scene holds {} spheres and {} unique materials ({} requested), {:.2f} KB", sceneStats.Spheres, sceneStats.Materials, sceneStats.MaterialRequests, static_cast<f32>(sceneStats.SphereMemory + sceneStats.MaterialMemory) / 1024.0f);
+
+        m_WideAggregate = WideBVH::Create(*m_Aggregate);
+        m_CompressedAggregate = WideBVH::Create(*m_Aggregate, WideBVHNodeFormat::Compressed);
+
+        // Bottom-level structures are shared, so count each one once
+        std::unordered_set<const Hittable*> geometry;
+        m_InstanceCount = 0;
+        m_GeometryMemory = 0;
+
+        for (const auto& primitive : m_Aggregate->GetPrimitives()) {
+            auto instance = dynamic_cast<const Instance*>(primitive.get());
+            if (!instance) continue;
+
+            m_InstanceCount++;
+            if (!geometry.insert(instance->GetGeometry().get()).second) continue;
+
+            if (auto blas = dynamic_cast<const BVH*>(instance->GetGeometry().get())) {
+                m_GeometryMemory += blas->GetStats().NodeMemory + blas->GetPrimitives().size() * sizeof(Sphere);
+            }
+        }
+
+        if (m_InstanceCount > 0) {
+            KINFO("Instanced {} copies of {} unique geometries ({:.2f} KB)", m_InstanceCount, geometry.size(), static_cast<f32>(m_GeometryMemory) / 1024.0f);
+        }
+    }
+
+    auto RTLayer::StepAnimation() -> void
+    {
+        Stop();
+
+        // Drift every instance a little, then refit the top level instead of rebuilding it
+        for (const auto& primitive : m_Aggregate->GetPrimitives()) {
+            auto instance = std::dynamic_pointer_cast<Instance>(primitive);
+            if (!instance) continue;
+
+            glm::vec3 drift = RNG::Vec3(-0.05f, 0.05f) * glm::vec3(1.0f, 0.0f, 1.0f);
+            instance->SetTransform(glm::translate(glm::mat4(1.0f), drift) * instance->GetTransform());
+        }
+
+        bool rebuilt = m_Aggregate->Refit();
+        KINFO("Animation step {} in {:.2f} ms", rebuilt ? "rebuilt" : "refit", rebuilt ? m_Aggregate->GetStats().BuildTime : m_Aggregate->GetStats().RefitTime);
+
+        m_WideAggregate = WideBVH::Create(*m_Aggregate);
+        m_CompressedAggregate = WideBVH::Create(*m_Aggregate, WideBVHNodeFormat::Compressed);
+    }
+
+    auto RTLayer::UploadView(const std::vector<Tile>& tiles) -> void
+    {
+        if (m_ViewMode == ViewMode::ErrorHeatmap) {
+            // One tile per chunk, like the upload; while a render holds the workers this runs on the main thread alone
+            JobSystem::ParallelFor(tiles.size(), 1, [&](usize begin, usize end) {
+                for (const Tile& tile : std::span(tiles).subspan(begin, end - begin)) {
+                    for (u32 y = tile.y; y < tile.y + tile.h; ++y) {
+                        for (u32 x = tile.x; x < tile.x + tile.w; ++x) {
+                            usize index = x + y * m_Resolution.x;
+                            f32 error = PixelError(m_Accumulator[index], m_HalfAccumulator[index]);
+                            m_Heatmap[index] = glm::vec4(ErrorHeatmap(error, m_Adaptive.Threshold), 1.0f);
+                        }
+                    }
+                }
+            });
+
+            m_PostProcess->UploadTiles(m_Heatmap, tiles);
+        } else {
+            m_PostProcess->UploadTiles(m_Accumulator, tiles);
+        }
+
+        m_PostProcess->Dispatch();
+    }
+
+    auto RTLayer::RenderJob() -> void
+    {
+        // Path state buffers are kept per worker and reused across tiles
+        WavefrontIntegrator wavefront;
+
         RenderTask task;
         while (m_Running && m_Scheduler.GetTask(task)) {
-            ExecuteTask(task);
+            if (m_IntegratorType == IntegratorType::Wavefront) {
+                ExecuteWavefrontTask(task, wavefront);
+            } else {
+                ExecuteTask(task);
+            }
+
+            // Both halves hold the same number of samples after an even pass; without adaptive sampling
+            // nothing reads the error, so the tile isn't walked for it
+            f32 error = std::numeric_limits<f32>::infinity();
+            if (m_Adaptive.Enabled && task.sample % 2 == 0) {
+                error = TileError(task.tile, m_Resolution.x, m_Accumulator, m_HalfAccumulator);
+            }
+
+            m_Scheduler.Complete(task, error);
             m_RenderQueue.Push(task.tile);
         }
     }
 
+    auto RTLayer::ExecuteWavefrontTask(const RenderTask& task, WavefrontIntegrator& integrator) -> void
+    {
+        WavefrontOptions options {
+            .MaxDepth = m_Depth,
+            .Sampling = m_SamplerType,
+            .Seed = m_Seed,
+            .MortonPixels = m_MortonPixels,
+            .SortRays = m_SortRays,
+            .SortByMaterial = m_SortByMaterial,
+            .NextEventEstimation = m_NextEventEstimation,
+            .Roulette = m_Roulette
+        };
+
+        auto stats = integrator.Render(task, *m_Camera, GetAggregate(), *m_Scene, options, m_Resolution.x, m_Accumulator, m_HalfAccumulator);
+
+        m_TotalRayCount += stats.Rays;
+        m_PathCount += task.tile.w * task.tile.h;
+        m_SecondaryRayCount += stats.SecondaryRays;
+        m_SortTime += stats.SortTime;
+        m_ExtendTime += stats.ExtendTime;
+        m_ShadeTime += stats.ShadeTime;
+    }
+
     auto RTLayer::ExecuteTask(const RenderTask& task) -> void
     {
+        // Packets go through the binary BVH, so with a wide BVH selected every ray traces on its own
+        if (m_AggregateType == AggregateType::BVH2) {
+            switch (m_PacketSize) {
+                case 4: ExecutePacketTask<4>(task); return;
+                case 8: ExecutePacketTask<8>(task); return;
+                case 16: ExecutePacketTask<16>(task); return;
+                default: break;
+            }
+        }
+
+        u64 taskRayCount = 0;
+
+        ForEachPixel(task.tile.w, task.tile.h, m_MortonPixels, [&](u32 localX, u32 localY) {
+            u32 x = task.tile.x + localX;
+            u32 y = task.tile.y + localY;
+
+            Sampler sampler(m_SamplerType, glm::uvec2(x, y), task.sample - 1, m_Seed);
+
+            glm::vec2 offset = sampler.Vec2() - 0.5f;
+            Ray ray = m_Camera->GetRay(x, y, offset, sampler.Vec2());
+
+            u32 pixelRays = 0;
+            glm::vec3 color = TraceRay(ray, sampler, pixelRays);
+            taskRayCount += pixelRays;
+
+            usize index = x + y * m_Resolution.x;
+            m_Accumulator[index] += glm::vec4(color, 0.0f);
+            m_Accumulator[index].a = static_cast<f32>(task.sample);
+
+            if (task.sample % 2 == 1) {
+                m_HalfAccumulator[index] += glm::vec4(color, 1.0f);
+            }
+        });
+
+        m_TotalRayCount += taskRayCount;
+        m_PathCount += task.tile.w * task.tile.h;
+    }
+
+    template <usize N>
+    auto RTLayer::ExecutePacketTask(const RenderTask& task) -> void
+    {
+        // Primary rays are traced as small pixel blocks; lanes outside the tile stay inactive
+        constexpr u32 BlockWidth = (N == 4) ? 2 : 4;
+        constexpr u32 BlockHeight = static_cast<u32>(N) / BlockWidth;
+
+        const Interval clip(0.0001f, std::numeric_limits<f32>::infinity());
+
         u64 taskRayCount = 0;
 
-        for (u32 y = task.tile.y; y < task.tile.y + task.tile.h; ++y) {
-            for (u32 x = task.tile.x; x < task.tile.x + task.tile.w; ++x) {
-                glm::vec2 offset = RNG::Vec2() - 0.5f;
-                Ray ray = m_Camera->GetRay(x, y, offset);
+        // Blocks follow the same order as single pixels, one grid cell per block
+        u32 blocksX = (task.tile.w + BlockWidth - 1) / BlockWidth;
+        u32 blocksY = (task.tile.h + BlockHeight - 1) / BlockHeight;
+
+        ForEachPixel(blocksX, blocksY, m_MortonPixels, [&](u32 blockX, u32 blockY) {
+            u32 bx = task.tile.x + blockX * BlockWidth;
+            u32 by = task.tile.y + blockY * BlockHeight;
+
+            RayPacket<N> packet;
+            std::array<Ray, N> rays;
+            std::array<Sampler, N> samplers;
+
+            for (u32 lane = 0; lane < N; ++lane) {
+                u32 x = bx + lane % BlockWidth;
+                u32 y = by + lane / BlockWidth;
+                if (x >= task.tile.x + task.tile.w || y >= task.tile.y + task.tile.h) continue;
+
+                samplers[lane] = Sampler(m_SamplerType, glm::uvec2(x, y), task.sample - 1, m_Seed);
+
+                glm::vec2 offset = samplers[lane].Vec2() - 0.5f;
+                rays[lane] = m_Camera->GetRay(x, y, offset, samplers[lane].Vec2());
+                packet.Set(lane, rays[lane]);
+            }
+
+            std::array<std::optional<SurfaceInteraction>, N> hits;
+            m_Aggregate->HitPacket(packet, clip, hits);
+
+            // Secondary bounces diverge, so each lane continues on its own from its primary hit
+            for (u32 lane = 0; lane < N; ++lane) {
+                if (!(packet.activeMask & (1u << lane))) continue;
+
+                u32 x = bx + lane % BlockWidth;
+                u32 y = by + lane / BlockWidth;
 
                 u32 pixelRays = 0;
-                glm::vec3 color = TraceRay(ray, pixelRays);
+                glm::vec3 color = TracePath(rays[lane], hits[lane], samplers[lane], pixelRays);
                 taskRayCount += pixelRays;
 
                 usize index = x + y * m_Resolution.x;
                 m_Accumulator[index] += glm::vec4(color, 0.0f);
                 m_Accumulator[index].a = static_cast<f32>(task.sample);
+
+                if (task.sample % 2 == 1) {
+                    m_HalfAccumulator[index] += glm::vec4(color, 1.0f);
+                }
             }
-        }
+        });
 
         m_TotalRayCount += taskRayCount;
+        m_PathCount += task.tile.w * task.tile.h;
+    }
+
+    auto RTLayer::TraceRay(Ray ray, Sampler& sampler, u32& rayCount) -> glm::vec3
+    {
+        auto hit = GetAggregate().Hit(ray, Interval(0.0001f, std::numeric_limits<f32>::infinity()));
+        return TracePath(ray, std::move(hit), sampler, rayCount);
     }
 
-    auto RTLayer::TraceRay(Ray ray, u32& rayCount) -> glm::vec3
+    auto RTLayer::TracePath(Ray ray, std::optional<SurfaceInteraction> hit, Sampler& sampler, u32& rayCount) -> glm::vec3
     {
         rayCount = 0;
 
+        const Hittable& aggregate = GetAggregate();
+        const MaterialTable materials = m_Scene->GetMaterials();
+        const LightTable lights = m_Scene->GetLights();
+
         glm::vec3 throughput(1.0f);
         glm::vec3 accumulated(0.0f);
 
+        // Density of the bounce that produced the current ray; camera rays count as specular
+        f32 bsdfPdf = 0.0f;
+
         for (u32 depth = 0; depth < m_Depth; ++depth) {
             rayCount++;
 
-            if (auto hit = m_Aggregate->Hit(ray, Interval(0.0001f, std::numeric_limits<f32>::infinity()))) {
-                // TODO: emissions
-                accumulated += throughput * glm::vec3(0.0f);
+            if (depth > 0) {
+                hit = aggregate.Hit(ray, Interval(0.0001f, std::numeric_limits<f32>::infinity()));
+            }
+
+            if (hit) {
+                const Material& material = materials[hit->material];
+                sampler.StartBounce(depth);
+
+                if (const auto* emitter = std::get_if<DiffuseLight>(&material)) {
+                    f32 weight = m_NextEventEstimation ? EmitterWeight(lights, *emitter, ray.origin, bsdfPdf) : 1.0f;
+                    accumulated += throughput * emitter->Emitted(*hit) * weight;
+                } else if (m_NextEventEstimation) {
+                    accumulated += throughput * EstimateDirect(aggregate, lights, material, ray, *hit, sampler);
+                }
 
-                if (auto scatter = hit->material->Scatter(ray, *hit)) {
+                if (auto scatter = Scatter(material, ray, *hit, sampler)) {
                     ray = scatter->scattered;
                     throughput *= scatter->attenuation;
+                    bsdfPdf = scatter->pdf;
+
+                    if (!RussianRoulette(throughput, depth + 1, m_Roulette, sampler)) break;
                 } else {
                     break;
                 }
             } else {
-                glm::vec3 dir = glm::normalize(ray.direction);
-                f32 t = 0.5f * (dir.y + 1.0f);
-                glm::vec3 sky = glm::mix(glm::vec3(1.0f), glm::vec3(0.5f, 0.7f, 1.0f), t);
-
-                accumulated += throughput * sky;
+                accumulated += throughput * SkyRadiance(ray.direction) * m_Scene->GetSkyIntensity();
                 break;
             }
         }
@@ -460,4 +983,17 @@ namespace Kyber {
         return accumulated;
     }
 
+    auto RTLayer::GetAggregate() const -> const Hittable&
+    {
+        switch (m_AggregateType) {
+            case AggregateType::BVH4:
+                return *m_WideAggregate;
+            case AggregateType::BVH4Compressed:
+                return *m_CompressedAggregate;
+            case AggregateType::BVH2:
+            default:
+                return *m_Aggregate;
+        }
+    }
+
 }
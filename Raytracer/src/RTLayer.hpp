@@ -5,15 +5,47 @@
 #include "Camera.hpp"
 
 #include "Acceleration/BVH.hpp"
+#include "Acceleration/WideBVH.hpp"
+
+#include "Integrators/WavefrontIntegrator.hpp"
 
 #include "Core/TileScheduler.hpp"
 #include "Core/RenderQueue.hpp"
 #include "Core/PostProcess.hpp"
+#include "Core/Sampler.hpp"
+#include "Core/AdaptiveSampling.hpp"
 
 namespace Kyber {
 
     class RTLayer final : public Layer
     {
+    public:
+        enum class AggregateType
+        {
+            BVH2,
+            BVH4,
+            BVH4Compressed
+        };
+
+        enum class SceneType
+        {
+            Book1,
+            InstancedField,
+            SphereLights
+        };
+
+        enum class IntegratorType
+        {
+            Megakernel,
+            Wavefront
+        };
+
+        enum class ViewMode
+        {
+            Image,
+            ErrorHeatmap
+        };
+
     public:
         RTLayer();
         virtual ~RTLayer() = default;
@@ -30,31 +62,83 @@ namespace Kyber {
         auto Stop() -> void;
         auto Reset() -> void;
 
-        auto WorkerThread() -> void;
+        auto LoadScene() -> void;
+        auto StepAnimation() -> void;
+
+        auto UploadView(const std::vector<Tile>& tiles) -> void;
+
+        auto RenderJob() -> void;
         auto ExecuteTask(const RenderTask& task) -> void;
-        auto TraceRay(Ray ray, u32& rayCount) -> glm::vec3;
+        auto ExecuteWavefrontTask(const RenderTask& task, WavefrontIntegrator& integrator) -> void;
+        auto TraceRay(Ray ray, Sampler& sampler, u32& rayCount) -> glm::vec3;
+        auto TracePath(Ray ray, std::optional<SurfaceInteraction> hit, Sampler& sampler, u32& rayCount) -> glm::vec3;
+
+        template <usize N>
+        auto ExecutePacketTask(const RenderTask& task) -> void;
+
+        auto GetAggregate() const -> const Hittable&;
 
     private:
         glm::uvec2 m_Resolution { 1920, 1080 };
         u32 m_Samples { 512 };
         u32 m_Depth { 8 };
         u32 m_TileSize { 32 };
+        TileOrder m_TileOrder { TileOrder::Hilbert };
+        bool m_MortonPixels { true };
+        u32 m_PacketSize { 16 };
+        bool m_SortRays { false };
+        bool m_SortByMaterial { false };
+        RussianRouletteOptions m_Roulette;
+        bool m_NextEventEstimation { true };
+        SamplerType m_SamplerType { SamplerType::Sobol };
+        u32 m_Seed { 0 };
+        AdaptiveSamplingOptions m_Adaptive;
+
+        BVHBuildOptions m_BuildOptions {
+            .SplitMethod = BVHSplitMethod::SAH,
+            .BinCount = 16
+        };
 
         TileScheduler m_Scheduler;
         RenderQueue m_RenderQueue;
 
+        // One long-running job per pool worker, each pulling tasks from the scheduler
         std::atomic<bool> m_Running { false };
-        std::vector<std::thread> m_Workers;
+        TaskGroup m_RenderJobs;
+
+        SceneType m_SceneType { SceneType::Book1 };
+        AggregateType m_AggregateType { AggregateType::BVH4 };
+        IntegratorType m_IntegratorType { IntegratorType::Megakernel };
+        ViewMode m_ViewMode { ViewMode::Image };
 
+        std::unique_ptr<Scene> m_Scene;
         std::unique_ptr<BVH> m_Aggregate;
+        std::unique_ptr<WideBVH> m_WideAggregate;
+        std::unique_ptr<WideBVH> m_CompressedAggregate;
         std::unique_ptr<Camera> m_Camera;
 
+        u32 m_InstanceCount { 0 };
+        usize m_GeometryMemory { 0 };
+
         std::vector<glm::vec4> m_Accumulator;
+
+        // Odd-numbered samples only, for the adaptive error estimate
+        std::vector<glm::vec4> m_HalfAccumulator;
+        std::vector<glm::vec4> m_Heatmap;
         std::unique_ptr<PostProcess> m_PostProcess;
 
         std::chrono::time_point<std::chrono::steady_clock> m_RenderStartTime;
         f32 m_AccumulatedTime { 0.0f };
         std::atomic<u64> m_TotalRayCount { 0 };
+        std::atomic<u64> m_PathCount { 0 };
+
+        // Average path length of the previous run, kept across a reset for comparison
+        f32 m_PreviousPathLength { 0.0f };
+
+        std::atomic<u64> m_SecondaryRayCount { 0 };
+        std::atomic<u64> m_SortTime { 0 };
+        std::atomic<u64> m_ExtendTime { 0 };
+        std::atomic<u64> m_ShadeTime { 0 };
     };
 
 }
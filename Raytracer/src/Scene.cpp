@@ -0,0 +1,86 @@
+#include "Scene.hpp"
+
+namespace Kyber {
+
+    Scene::Scene(usize sphereCapacity, usize materialCapacity)
+        : m_Spheres(&m_Arena)
+        , m_Materials(&m_Arena)
+        , m_MaterialLookup(&m_Arena)
+        , m_Lights(&m_Arena)
+    {
+        m_Spheres.Reserve(sphereCapacity);
+        m_Materials.reserve(materialCapacity);
+        m_MaterialLookup.reserve(materialCapacity);
+    }
+
+    auto Scene::AddSphere(const glm::vec3& center, f32 radius, u32 material) -> void
+    {
+        m_Spheres.Push(center, radius, material);
+    }
+
+    auto Scene::AddLambertian(const glm::vec3& albedo) -> u32
+    {
+        return Intern<Lambertian>(MaterialKey { MaterialKind::Lambertian, albedo, 0.0f }, albedo);
+    }
+
+    auto Scene::AddMetal(const glm::vec3& albedo, f32 fuzz) -> u32
+    {
+        return Intern<Metal>(MaterialKey { MaterialKind::Metal, albedo, fuzz }, albedo, fuzz);
+    }
+
+    auto Scene::AddDielectric(f32 ri) -> u32
+    {
+        return Intern<Dielectric>(MaterialKey { MaterialKind::Dielectric, glm::vec3(0.0f), ri }, ri);
+    }
+
+    auto Scene::AddSphereLight(const glm::vec3& center, f32 radius, const glm::vec3& emission) -> void
+    {
+        // The light index is part of the key, so every light keeps a material of its own
+        u32 light = static_cast<u32>(m_Lights.size());
+        m_Lights.push_back(SphereLight { center, radius, emission });
+
+        u32 material = Intern<DiffuseLight>(MaterialKey { MaterialKind::DiffuseLight, emission, static_cast<f32>(light) }, emission, light);
+        AddSphere(center, radius, material);
+    }
+
+    auto Scene::PermuteSpheres(std::span<const u32> order) -> void
+    {
+        m_Spheres.Permute(order);
+    }
+
+    auto Scene::GetStats() const -> Stats
+    {
+        return Stats {
+            .Spheres = m_Spheres.Size(),
+            .Materials = static_cast<u32>(m_Materials.size()),
+            .Lights = static_cast<u32>(m_Lights.size()),
+            .MaterialRequests = m_MaterialRequests,
+            .SphereMemory = m_Spheres.GetMemoryUsage(),
+            .MaterialMemory = m_Materials.capacity() * sizeof(Material)
+        };
+    }
+
+    auto Scene::MaterialKeyHash::operator()(const MaterialKey& key) const -> usize
+    {
+        usize hash = static_cast<usize>(key.kind);
+        for (f32 value : { key.albedo.x, key.albedo.y, key.albedo.z, key.parameter }) {
+            hash ^= std::hash<f32>{}(value) + 0x9e3779b97f4a7c15ull + (hash << 6) + (hash >> 2);
+        }
+
+        return hash;
+    }
+
+    template <typename TMaterial, typename... Args>
+    auto Scene::Intern(const MaterialKey& key, Args&&... args) -> u32
+    {
+        m_MaterialRequests++;
+
+        auto [it, inserted] = m_MaterialLookup.try_emplace(key, static_cast<u32>(m_Materials.size()));
+        if (!inserted) return it->second;
+
+        m_Materials.emplace_back(std::in_place_type<TMaterial>, std::forward<Args>(args)...);
+
+        return it->second;
+    }
+
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Acceleration/SphereSoA.hpp"
+#include "Materials/Material.hpp"
+#include "Integrators/LightSampling.hpp"
+
+namespace Kyber {
+
+    // Owns the scene's primitives as typed arrays and its materials as an interned table, all
+    // allocated from one arena. A BVH built over the scene indexes straight into these arrays.
+    class Scene
+    {
+    public:
+        struct Stats
+        {
+            u32 Spheres { 0 };
+            u32 Materials { 0 };
+            u32 Lights { 0 };
+            u32 MaterialRequests { 0 };
+            usize SphereMemory { 0 };
+            usize MaterialMemory { 0 };
+        };
+
+    public:
+        // Capacities are hints; reserving up front keeps the arena from holding outgrown buffers
+        Scene(usize sphereCapacity = 0, usize materialCapacity = 0);
+        ~Scene() = default;
+
+        Scene(const Scene&) = delete;
+        auto operator=(const Scene&) -> Scene& = delete;
+
+        auto AddSphere(const glm::vec3& center, f32 radius, u32 material) -> void;
+
+        // Identical parameters return the index of the existing material
+        auto AddLambertian(const glm::vec3& albedo) -> u32;
+        auto AddMetal(const glm::vec3& albedo, f32 fuzz) -> u32;
+        auto AddDielectric(f32 ri) -> u32;
+
+        // Adds an emissive sphere that is also registered for light sampling
+        auto AddSphereLight(const glm::vec3& center, f32 radius, const glm::vec3& emission) -> void;
+
+        // Scales the gradient sky; scenes lit by their own lights turn it down or off
+        auto SetSkyIntensity(f32 intensity) -> void { m_SkyIntensity = intensity; }
+
+        // Applies a BVH leaf order to the sphere arrays
+        auto PermuteSpheres(std::span<const u32> order) -> void;
+
+        auto GetSpheres() const -> const SphereSoA& { return m_Spheres; }
+        auto GetMaterials() const -> MaterialTable { return m_Materials; }
+        auto GetLights() const -> LightTable { return m_Lights; }
+        auto GetSkyIntensity() const -> f32 { return m_SkyIntensity; }
+        auto GetStats() const -> Stats;
+
+    private:
+        enum class MaterialKind : u8
+        {
+            Lambertian,
+            Metal,
+            Dielectric,
+            DiffuseLight
+        };
+
+        struct MaterialKey
+        {
+            MaterialKind kind;
+            glm::vec3 albedo;
+            f32 parameter;
+
+            auto operator==(const MaterialKey& other) const -> bool = default;
+        };
+
+        struct MaterialKeyHash
+        {
+            auto operator()(const MaterialKey& key) const -> usize;
+        };
+
+        template <typename TMaterial, typename... Args>
+        auto Intern(const MaterialKey& key, Args&&... args) -> u32;
+
+    private:
+        std::pmr::monotonic_buffer_resource m_Arena;
+
+        SphereSoA m_Spheres;
+        std::pmr::vector<Material> m_Materials;
+        std::pmr::unordered_map<MaterialKey, u32, MaterialKeyHash> m_MaterialLookup;
+        std::pmr::vector<SphereLight> m_Lights;
+
+        u32 m_MaterialRequests { 0 };
+        f32 m_SkyIntensity { 1.0f };
+    };
+
+}